@@ -66,6 +66,13 @@ using DistGraphPtr =
  * this argument assigns a weight to give each node.
  * @param edgeWeight When using a read policy that involves nodes and edges,
  * this argument assigns a weight to give each edge.
+ * @param streamMemoryBudget If non-zero, bytes each host may use to buffer
+ * edges read from disk and edges being sent to other hosts; edges are then
+ * streamed from disk in windows instead of being read all at once. Edges
+ * received from other hosts are not counted against it.
+ * @param localGraphFile If non-empty, prefix of local graph files saved by
+ * DistGraph::save_local_graph_to_file in an earlier run; the partition is
+ * read from them instead of being computed
  *
  * @tparam PartitionPolicy Partitioning policy object that specifies the
  * placement of nodes/edges during partitioning.
@@ -89,12 +96,14 @@ cuspPartitionGraph(std::string graphFile, CUSP_GRAPH_TYPE inputType,
                    uint32_t cuspStateRounds = 100,
                    galois::graphs::MASTERS_DISTRIBUTION readPolicy =
                        galois::graphs::BALANCED_EDGES_OF_MASTERS,
-                   uint32_t nodeWeight = 0, uint32_t edgeWeight = 0) {
+                   uint32_t nodeWeight = 0, uint32_t edgeWeight = 0,
+                   uint64_t streamMemoryBudget = 0,
+                   std::string localGraphFile = "") {
   auto& net = galois::runtime::getSystemNetworkInterface();
   using DistGraphConstructor =
       galois::graphs::NewDistGraphGeneric<NodeData, EdgeData, PartitionPolicy>;
 
-  // TODO @todo bring back graph saving/reading functionality?
+  bool readFromFile = !localGraphFile.empty();
 
   if (!symmetricGraph) {
     // out edges or in edges
@@ -127,13 +136,15 @@ cuspPartitionGraph(std::string graphFile, CUSP_GRAPH_TYPE inputType,
 
     return std::make_unique<DistGraphConstructor>(
         inputToUse, net.ID, net.Num, cuspAsync, cuspStateRounds, useTranspose,
-        readPolicy, nodeWeight, edgeWeight, masterBlockFile);
+        readPolicy, nodeWeight, edgeWeight, masterBlockFile,
+        readFromFile, localGraphFile, 1, streamMemoryBudget);
   } else {
     // symmetric graph path: assume the passed in graphFile is a symmetric
     // graph; output is also symmetric
     return std::make_unique<DistGraphConstructor>(
         graphFile, net.ID, net.Num, cuspAsync, cuspStateRounds, false,
-        readPolicy, nodeWeight, edgeWeight, masterBlockFile);
+        readPolicy, nodeWeight, edgeWeight, masterBlockFile,
+        readFromFile, localGraphFile, 1, streamMemoryBudget);
   }
 }
 } // end namespace galois
@@ -127,6 +127,15 @@ protected:
   //! LID = globalToLocalMap[GID]
   std::unordered_map<uint64_t, uint32_t> globalToLocalMap;
 
+  // partitioning information of a local graph read from a file, which has
+  // no partitioner to query
+  //! Host of the master of each mirror on this host
+  std::unordered_map<uint64_t, uint32_t> cachedMirrorHosts;
+  //! True if the cached partition is a vertex cut
+  bool cachedVertexCut = false;
+  //! Cartesian grid of the cached partition (if any)
+  std::pair<unsigned, unsigned> cachedCartesianGrid{0u, 0u};
+
   //! Increments evilPhase, a phase counter used by communication.
   void inline increment_evilPhase() {
     ++galois::runtime::evilPhase;
@@ -845,21 +854,232 @@ protected:
    */
   void edgesEqualMasters() { specificRanges[2] = specificRanges[1]; }
 
+  /**
+   * Determines the host of the master of a node using the partitioning
+   * information saved with a local graph read from a file.
+   *
+   * @param gid Global id of a node with a proxy on this host
+   * @returns Host id of the master of the node
+   */
+  unsigned cachedHostID(uint64_t gid) const {
+    auto lid = globalToLocalMap.find(gid);
+    if (lid != globalToLocalMap.end() && lid->second >= beginMaster &&
+        lid->second < beginMaster + numOwned) {
+      return id;
+    }
+    auto host = cachedMirrorHosts.find(gid);
+    if (host == cachedMirrorHosts.end()) {
+      GALOIS_DIE("master of node ", gid, " is unknown to the local graph ",
+                 "read from file");
+    }
+    return host->second;
+  }
+
+private:
+  //! Marks the beginning of a file written by save_local_graph_to_file
+  static constexpr uint64_t localGraphFileMagic = 0x4c434c4752415048;
+  //! Number of 64-bit fields in the header of a local graph file
+  static constexpr size_t localGraphHeaderSize = 14;
+
+  //! Size of an edge's data in a local graph file
+  static constexpr uint64_t localGraphEdgeDataSize() {
+    if constexpr (std::is_void<EdgeTy>::value) {
+      return 0;
+    } else {
+      return sizeof(EdgeTy);
+    }
+  }
+
+  //! Writes a vector to a local graph file, preceded by its length
+  template <typename T>
+  static void writeLocalGraphVector(std::ofstream& out,
+                                    const std::vector<T>& v) {
+    uint64_t count = v.size();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(v.data()), count * sizeof(T));
+  }
+
+  //! Reads a vector written by writeLocalGraphVector
+  template <typename T>
+  static void readLocalGraphVector(std::ifstream& in, std::vector<T>& v) {
+    uint64_t count = 0;
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    v.resize(count);
+    in.read(reinterpret_cast<char*>(v.data()), count * sizeof(T));
+  }
+
 public:
   /**
-   * Write the local LC_CSR graph to the file on a disk.
+   * Write the local LC_CSR graph to the file on a disk along with the
+   * proxy information Gluon needs, so that a later run on the same number
+   * of hosts can skip partitioning. Node data is not saved.
+   *
+   * Must be called before a Gluon substrate is constructed on this graph,
+   * as the substrate converts mirrors to local ids.
    *
-   * @todo revive this
+   * @param localGraphFileName Prefix of the file to write; the host id is
+   * appended to it
    */
-  void save_local_graph_to_file(std::string) { GALOIS_DIE("not implemented"); }
+  void save_local_graph_to_file(std::string localGraphFileName) {
+    static_assert(std::is_void<EdgeTy>::value ||
+                      std::is_trivially_copyable<EdgeTy>::value,
+                  "local graph files need trivially copyable edge data");
+    galois::StatTimer saveTimer("SaveLocalGraphTime", GRNAME);
+    saveTimer.start();
+
+    std::string fileName = localGraphFileName + "_" + std::to_string(id);
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      GALOIS_DIE("failed to open ", fileName, " to save the local graph");
+    }
+
+    std::pair<unsigned, unsigned> grid = cartesianGrid();
+    uint64_t header[localGraphHeaderSize] = {localGraphFileMagic,
+                                             numHosts,
+                                             numGlobalNodes,
+                                             numGlobalEdges,
+                                             numNodes,
+                                             numEdges,
+                                             numOwned,
+                                             beginMaster,
+                                             numNodesWithEdges,
+                                             transposed,
+                                             is_vertex_cut(),
+                                             grid.first,
+                                             grid.second,
+                                             localGraphEdgeDataSize()};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    writeLocalGraphVector(out, gid2host);
+    writeLocalGraphVector(out, localToGlobalVector);
+    for (unsigned h = 0; h < numHosts; ++h) {
+      writeLocalGraphVector(out, mirrorNodes[h]);
+    }
+
+    std::vector<uint64_t> edgeEnds(numNodes);
+    std::vector<uint32_t> edgeDsts(numEdges);
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t{numNodes}),
+        [&](size_t n) {
+          edgeEnds[n] = *graph.edge_end(n);
+          for (auto e : graph.edges(n)) {
+            edgeDsts[*e] = graph.getEdgeDst(e);
+          }
+        },
+        galois::no_stats());
+    writeLocalGraphVector(out, edgeEnds);
+    writeLocalGraphVector(out, edgeDsts);
+
+    if constexpr (!std::is_void<EdgeTy>::value) {
+      std::vector<EdgeTy> edgeData(numEdges);
+      galois::do_all(
+          galois::iterate(size_t{0}, size_t{numNodes}),
+          [&](size_t n) {
+            for (auto e : graph.edges(n)) {
+              edgeData[*e] = graph.getEdgeData(e);
+            }
+          },
+          galois::no_stats());
+      writeLocalGraphVector(out, edgeData);
+    }
+
+    if (!out) {
+      GALOIS_DIE("failed to write the local graph to ", fileName);
+    }
+    out.close();
+    saveTimer.stop();
+  }
 
   /**
-   * Read the local LC_CSR graph from the file on a disk.
+   * Read the local LC_CSR graph from a file written by
+   * save_local_graph_to_file and set up the graph as if it had just been
+   * partitioned. Partitioning information the partitioner would otherwise
+   * answer is restored into the cached* members.
    *
-   * @todo revive this
+   * @param localGraphFileName Prefix of the file to read; the host id is
+   * appended to it
    */
-  void read_local_graph_from_file(std::string) {
-    GALOIS_DIE("not implemented");
+  void read_local_graph_from_file(std::string localGraphFileName) {
+    std::string fileName = localGraphFileName + "_" + std::to_string(id);
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in.is_open()) {
+      GALOIS_DIE("failed to open ", fileName, " to read the local graph");
+    }
+
+    uint64_t header[localGraphHeaderSize];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != localGraphFileMagic) {
+      GALOIS_DIE(fileName, " is not a local graph file");
+    }
+    if (header[1] != numHosts) {
+      GALOIS_DIE(fileName, " was saved for ", header[1], " hosts, not ",
+                 numHosts);
+    }
+    if (header[13] != localGraphEdgeDataSize()) {
+      GALOIS_DIE(fileName, " has edge data of ", header[13],
+                 " bytes; expected ", localGraphEdgeDataSize());
+    }
+    numGlobalNodes      = header[2];
+    numGlobalEdges      = header[3];
+    numNodes            = header[4];
+    numEdges            = header[5];
+    numOwned            = header[6];
+    beginMaster         = header[7];
+    numNodesWithEdges   = header[8];
+    transposed          = header[9];
+    cachedVertexCut     = header[10];
+    cachedCartesianGrid = std::make_pair(header[11], header[12]);
+
+    readLocalGraphVector(in, gid2host);
+    readLocalGraphVector(in, localToGlobalVector);
+    for (unsigned h = 0; h < numHosts; ++h) {
+      readLocalGraphVector(in, mirrorNodes[h]);
+      for (size_t gid : mirrorNodes[h]) {
+        cachedMirrorHosts[gid] = h;
+      }
+    }
+
+    globalToLocalMap.reserve(numNodes);
+    for (uint32_t lid = 0; lid < numNodes; ++lid) {
+      globalToLocalMap[localToGlobalVector[lid]] = lid;
+    }
+
+    std::vector<uint64_t> edgeEnds;
+    std::vector<uint32_t> edgeDsts;
+    readLocalGraphVector(in, edgeEnds);
+    readLocalGraphVector(in, edgeDsts);
+
+    graph.allocateFrom(numNodes, numEdges);
+    graph.constructNodes();
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t{numNodes}),
+        [&](size_t n) { graph.fixEndEdge(n, edgeEnds[n]); },
+        galois::no_stats());
+
+    if constexpr (std::is_void<EdgeTy>::value) {
+      galois::do_all(
+          galois::iterate(uint64_t{0}, numEdges),
+          [&](uint64_t e) { graph.constructEdge(e, edgeDsts[e]); },
+          galois::no_stats());
+    } else {
+      std::vector<EdgeTy> edgeData;
+      readLocalGraphVector(in, edgeData);
+      galois::do_all(
+          galois::iterate(uint64_t{0}, numEdges),
+          [&](uint64_t e) {
+            graph.constructEdge(e, edgeDsts[e], edgeData[e]);
+          },
+          galois::no_stats());
+    }
+
+    if (!in) {
+      GALOIS_DIE(fileName, " is truncated");
+    }
+
+    determineThreadRanges();
+    determineThreadRangesMaster();
+    determineThreadRangesWithEdges();
+    initializeSpecificRanges();
   }
 
   /**
@@ -881,6 +1101,19 @@ public:
         [&](GN n) { graph.sortEdges(n, IdLess<GN, EdgeTy>()); },
         galois::no_stats(), galois::loopname("CSREdgeSort"), galois::steal());
   }
+
+  /**
+   * Sort the underlying LC_CSR_Graph by edge data
+   * It sorts edges of the nodes in increasing order of their data.
+   */
+  void sortEdgesByEdgeData() {
+    using GN = typename GraphTy::GraphNode;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GN n) { graph.sortEdgesByEdgeData(n, std::less<EdgeTy>()); },
+        galois::no_stats(), galois::loopname("CSREdgeDataSort"),
+        galois::steal());
+  }
 };
 
 template <typename NodeTy, typename EdgeTy>
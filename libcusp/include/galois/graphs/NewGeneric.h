@@ -29,6 +29,7 @@
 
 #include "galois/graphs/DistributedGraph.h"
 #include "galois/DReducible.h"
+#include <limits>
 #include <optional>
 #include <sstream>
 
@@ -47,9 +48,27 @@ template <typename NodeTy, typename EdgeTy, typename Partitioner>
 class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
   //! size used to buffer edge sends during partitioning
   constexpr static unsigned edgePartitionSendBufSize = 8388608;
-  constexpr static const char* const GRNAME          = "dGraph_Generic";
+  //! smallest per-thread, per-host send buffer used when streaming
+  constexpr static unsigned minStreamSendBufSize = 65536;
+  constexpr static const char* const GRNAME      = "dGraph_Generic";
   std::unique_ptr<Partitioner> graphPartitioner;
 
+  //! send buffer size that triggers a send during edge loading
+  uint64_t sendBufSizeLimit = edgePartitionSendBufSize;
+  //! graph file being partitioned; streaming mode rereads windows from it
+  std::string graphFileName;
+  //! node boundaries of the edge windows streamed from disk; empty if the
+  //! read range of this host is buffered all at once
+  std::vector<uint64_t> streamWindowNodes;
+  //! first global edge of each node boundary in streamWindowNodes
+  std::vector<uint64_t> streamWindowEdges;
+  //! loadedStreamWindow value when no window is in the buffered graph
+  constexpr static size_t noStreamWindow = std::numeric_limits<size_t>::max();
+  //! loadedStreamWindow value when the entire read range is buffered
+  constexpr static size_t wholeReadRange = noStreamWindow - 1;
+  //! index of the window currently in the buffered graph
+  size_t loadedStreamWindow = noStreamWindow;
+
   //! How many rounds to sync state during edge assignment phase
   uint32_t _edgeStateRounds;
   std::vector<galois::DGAccumulator<uint64_t>> hostLoads;
@@ -80,13 +99,23 @@ public:
   using base_DistGraph = DistGraph<NodeTy, EdgeTy>;
 
 private:
+  // a graph read from a file has no partitioner; it answers from the
+  // partitioning information saved with it instead
+
   virtual unsigned getHostIDImpl(uint64_t gid) const {
     assert(gid < base_DistGraph::numGlobalNodes);
+    if (!graphPartitioner) {
+      return base_DistGraph::cachedHostID(gid);
+    }
     return graphPartitioner->retrieveMaster(gid);
   }
 
   virtual bool isOwnedImpl(uint64_t gid) const {
     assert(gid < base_DistGraph::numGlobalNodes);
+    if (!graphPartitioner) {
+      return base_DistGraph::isLocal(gid) &&
+             base_DistGraph::cachedHostID(gid) == base_DistGraph::id;
+    }
     return (graphPartitioner->retrieveMaster(gid) == base_DistGraph::id);
   }
 
@@ -101,9 +130,15 @@ private:
   // if an outgoing mirror is marked as having an incoming edge on any
   // host
   virtual bool isVertexCutImpl() const {
+    if (!graphPartitioner) {
+      return base_DistGraph::cachedVertexCut;
+    }
     return graphPartitioner->isVertexCut();
   }
   virtual std::pair<unsigned, unsigned> cartesianGridImpl() const {
+    if (!graphPartitioner) {
+      return base_DistGraph::cachedCartesianGrid;
+    }
     return graphPartitioner->cartesianGrid();
   }
 
@@ -154,6 +189,14 @@ public:
 
   /**
    * Constructor
+   *
+   * @param streamMemoryBudget If non-zero, the number of bytes this host may
+   * use for buffering edges read from disk and edges waiting to be sent to
+   * their owners. Edges are then read in windows that fit in half of the
+   * budget instead of all at once, and send buffers share the other half.
+   * Partitioners with a master assignment phase still buffer the whole read
+   * range for that phase; it is released before the graph is allocated.
+   * Edges received from other hosts are not counted against the budget.
    */
   NewDistGraphGeneric(
       const std::string& filename, unsigned host, unsigned _numHosts,
@@ -162,8 +205,9 @@ public:
       uint32_t nodeWeight = 0, uint32_t edgeWeight = 0,
       std::string masterBlockFile = "", bool readFromFile = false,
       std::string localGraphFileName = "local_graph",
-      uint32_t edgeStateRounds       = 1)
-      : base_DistGraph(host, _numHosts), _edgeStateRounds(edgeStateRounds) {
+      uint32_t edgeStateRounds       = 1, uint64_t streamMemoryBudget = 0)
+      : base_DistGraph(host, _numHosts), graphFileName(filename),
+        _edgeStateRounds(edgeStateRounds) {
     galois::runtime::reportParam("dGraph", "GenericPartitioner", "0");
     galois::CondStatTimer<MORE_DIST_STATS> Tgraph_construct(
         "GraphPartitioningTime", GRNAME);
@@ -220,18 +264,27 @@ public:
       hasIncomingEdge.resize(base_DistGraph::numHosts);
     }
 
+    if (streamMemoryBudget) {
+      setupStreaming(g, nodeBegin, nodeEnd, streamMemoryBudget);
+    }
+
     // phase 0
 
-    galois::gPrint("[", base_DistGraph::id, "] Starting graph reading.\n");
     galois::graphs::BufferedGraph<EdgeTy> bufGraph;
     bufGraph.resetReadCounters();
-    galois::StatTimer graphReadTimer("GraphReading", GRNAME);
-    graphReadTimer.start();
-    bufGraph.loadPartialGraph(filename, nodeBegin, nodeEnd, *edgeBegin,
-                              *edgeEnd, base_DistGraph::numGlobalNodes,
-                              base_DistGraph::numGlobalEdges);
-    graphReadTimer.stop();
-    galois::gPrint("[", base_DistGraph::id, "] Reading graph complete.\n");
+    // streaming reads windows on demand; the master assignment phase still
+    // needs the entire read range
+    if (streamWindowNodes.empty() || graphPartitioner->masterAssignPhase()) {
+      galois::gPrint("[", base_DistGraph::id, "] Starting graph reading.\n");
+      galois::StatTimer graphReadTimer("GraphReading", GRNAME);
+      graphReadTimer.start();
+      bufGraph.loadPartialGraph(filename, nodeBegin, nodeEnd, *edgeBegin,
+                                *edgeEnd, base_DistGraph::numGlobalNodes,
+                                base_DistGraph::numGlobalEdges);
+      loadedStreamWindow = wholeReadRange;
+      graphReadTimer.stop();
+      galois::gPrint("[", base_DistGraph::id, "] Reading graph complete.\n");
+    }
 
     if (graphPartitioner->masterAssignPhase()) {
       // loop over all nodes, determine where neighbors are, assign masters
@@ -265,13 +318,20 @@ public:
       finalIncoming.resize(0);
     } else {
       base_DistGraph::numOwned = nodeEnd - nodeBegin;
-      uint64_t edgeOffset      = *bufGraph.edgeBegin(nodeBegin);
+      uint64_t edgeOffset      = *edgeBegin;
       // edge prefix sum, no comm required
       edgeCutInspection(bufGraph, inspectionTimer, edgeOffset,
                         prefixSumOfEdges);
     }
     // inspection timer is stopped in edgeInspection function
 
+    // the master assignment phase made the whole read range resident;
+    // release it before the graph is allocated and stream from here on
+    if (!streamWindowNodes.empty() && loadedStreamWindow == wholeReadRange) {
+      bufGraph.resetAndFree();
+      loadedStreamWindow = noStreamWindow;
+    }
+
     // flip partitioners that have a master assignment phase to stage 2
     // (meaning all nodes and masters that will be on this host are present in
     // the partitioner's metadata)
@@ -367,6 +427,130 @@ public:
   }
 
 private:
+  //! @returns number of bytes of edge data buffered per edge
+  static constexpr size_t bufferedEdgeDataSize() {
+    if constexpr (std::is_void<EdgeTy>::value) {
+      return 0;
+    } else {
+      return sizeof(EdgeTy);
+    }
+  }
+
+  /**
+   * Splits this host's read range into windows of consecutive nodes whose
+   * buffered edges fit in half of the memory budget and sizes the edge send
+   * buffers so that all of them together (including the slack reserved when
+   * a buffer is recycled) fit in the other half. A node with more edges than
+   * fit in a window gets a window of its own.
+   *
+   * Send buffers are never made smaller than minStreamSendBufSize; if that
+   * floor exceeds the budget, a warning reports the resulting peak. Buffers
+   * of edges received from other hosts are not counted against the budget.
+   *
+   * @param g offline graph used to find edge offsets of nodes
+   * @param nodeBegin first node read by this host
+   * @param nodeEnd one past the last node read by this host
+   * @param memoryBudget bytes available for buffering edges
+   */
+  void setupStreaming(galois::graphs::OfflineGraph& g, uint64_t nodeBegin,
+                      uint64_t nodeEnd, uint64_t memoryBudget) {
+    const uint64_t windowBytes = memoryBudget / 2;
+    const uint64_t nodeBytes   = sizeof(uint64_t);
+    const uint64_t edgeBytes   = sizeof(uint32_t) + bufferedEdgeDataSize();
+
+    streamWindowNodes.clear();
+    streamWindowEdges.clear();
+    streamWindowNodes.push_back(nodeBegin);
+    streamWindowEdges.push_back(*g.edge_begin(nodeBegin));
+
+    uint64_t cur = nodeBegin;
+    while (cur < nodeEnd) {
+      uint64_t curEdge = streamWindowEdges.back();
+      // binary search for the furthest window end that fits
+      uint64_t lo = cur + 1;
+      uint64_t hi = nodeEnd;
+      while (lo < hi) {
+        uint64_t mid   = lo + (hi - lo + 1) / 2;
+        uint64_t bytes = (mid - cur) * nodeBytes +
+                         (*g.edge_begin(mid) - curEdge) * edgeBytes;
+        if (bytes <= windowBytes) {
+          lo = mid;
+        } else {
+          hi = mid - 1;
+        }
+      }
+      cur = lo;
+      streamWindowNodes.push_back(cur);
+      streamWindowEdges.push_back(*g.edge_begin(cur));
+    }
+
+    uint64_t numBuffers = galois::runtime::activeThreads *
+                          std::max(base_DistGraph::numHosts - 1, 1u);
+    // a buffer reserves 1.25 times the limit when it is recycled
+    uint64_t fittingLimit = (memoryBudget - windowBytes) * 4 / (numBuffers * 5);
+    sendBufSizeLimit = std::max<uint64_t>(minStreamSendBufSize, fittingLimit);
+    sendBufSizeLimit = std::min<uint64_t>(edgePartitionSendBufSize,
+                                          sendBufSizeLimit);
+    uint64_t peakBytes = windowBytes + numBuffers * sendBufSizeLimit * 5 / 4;
+    if (peakBytes > memoryBudget) {
+      galois::gWarn("[", base_DistGraph::id, "] Partitioning memory budget of ",
+                    memoryBudget, " bytes is too small for ", numBuffers,
+                    " send buffers of at least ", minStreamSendBufSize,
+                    " bytes; buffering may use up to ", peakBytes, " bytes");
+    }
+
+    galois::gPrint("[", base_DistGraph::id, "] Streaming ",
+                   streamWindowEdges.back() - streamWindowEdges.front(),
+                   " edges in ", streamWindowNodes.size() - 1,
+                   " windows; send buffer limit ", sendBufSizeLimit,
+                   " bytes\n");
+    galois::runtime::reportStat_Single(GRNAME, "StreamWindows",
+                                       streamWindowNodes.size() - 1);
+    galois::runtime::reportStat_Single(GRNAME, "StreamSendBufferLimit",
+                                       sendBufSizeLimit);
+    galois::runtime::reportStat_Single(GRNAME, "StreamPeakBufferBytes",
+                                       peakBytes);
+  }
+
+  /**
+   * Calls fn(windowBegin, windowEnd) such that bufGraph has the edges of all
+   * nodes in [windowBegin, windowEnd) loaded and the calls cover
+   * [beginNode, endNode). If bufGraph already has the whole read range
+   * (no streaming, or streaming right after the master assignment phase), fn
+   * is called once on the entire range; otherwise each window overlapping
+   * the range is read into bufGraph (replacing the previous one, unless it
+   * is the window already loaded) before fn is called on the overlap.
+   *
+   * @param bufGraph buffered graph to (re)load windows into
+   * @param beginNode first node to process
+   * @param endNode one past the last node to process
+   * @param fn function to call on each window
+   */
+  template <typename FnTy>
+  void forEachEdgeWindow(galois::graphs::BufferedGraph<EdgeTy>& bufGraph,
+                         uint64_t beginNode, uint64_t endNode, FnTy fn) {
+    if (streamWindowNodes.empty() || loadedStreamWindow == wholeReadRange) {
+      fn(beginNode, endNode);
+      return;
+    }
+
+    for (size_t w = 0; w + 1 < streamWindowNodes.size(); w++) {
+      uint64_t windowBegin = std::max(beginNode, streamWindowNodes[w]);
+      uint64_t windowEnd   = std::min(endNode, streamWindowNodes[w + 1]);
+      if (windowBegin >= windowEnd) {
+        continue;
+      }
+      if (loadedStreamWindow != w) {
+        bufGraph.reloadPartialGraph(
+            graphFileName, streamWindowNodes[w], streamWindowNodes[w + 1],
+            streamWindowEdges[w], streamWindowEdges[w + 1],
+            base_DistGraph::numGlobalNodes, base_DistGraph::numGlobalEdges);
+        loadedStreamWindow = w;
+      }
+      fn(windowBegin, windowEnd);
+    }
+  }
+
   galois::runtime::SpecificRange<boost::counting_iterator<size_t>>
   getSpecificThreadRange(galois::graphs::BufferedGraph<EdgeTy>& bufGraph,
                          std::vector<uint32_t>& assignedThreadRanges,
@@ -1481,25 +1665,29 @@ private:
     prefixSumOfEdges.resize(base_DistGraph::numOwned);
 
     auto& ltgv = base_DistGraph::localToGlobalVector;
-    galois::do_all(
-        galois::iterate(base_DistGraph::gid2host[base_DistGraph::id].first,
-                        base_DistGraph::gid2host[base_DistGraph::id].second),
-        [&](size_t n) {
-          auto ii = bufGraph.edgeBegin(n);
-          auto ee = bufGraph.edgeEnd(n);
-          for (; ii < ee; ++ii) {
-            uint32_t dst = bufGraph.edgeDestination(*ii);
-            if (graphPartitioner->retrieveMaster(dst) != myID) {
-              incomingMirrors.set(dst);
-            }
-          }
-          prefixSumOfEdges[n - globalOffset] = (*ee) - edgeOffset;
-          ltgv[n - globalOffset]             = n;
-        },
+    forEachEdgeWindow(
+        bufGraph, base_DistGraph::gid2host[base_DistGraph::id].first,
+        base_DistGraph::gid2host[base_DistGraph::id].second,
+        [&](uint64_t windowBegin, uint64_t windowEnd) {
+          galois::do_all(
+              galois::iterate(windowBegin, windowEnd),
+              [&](size_t n) {
+                auto ii = bufGraph.edgeBegin(n);
+                auto ee = bufGraph.edgeEnd(n);
+                for (; ii < ee; ++ii) {
+                  uint32_t dst = bufGraph.edgeDestination(*ii);
+                  if (graphPartitioner->retrieveMaster(dst) != myID) {
+                    incomingMirrors.set(dst);
+                  }
+                }
+                prefixSumOfEdges[n - globalOffset] = (*ee) - edgeOffset;
+                ltgv[n - globalOffset]             = n;
+              },
 #if MORE_DIST_STATS
-        galois::loopname("EdgeInspectionLoop"),
+              galois::loopname("EdgeInspectionLoop"),
 #endif
-        galois::steal(), galois::no_stats());
+              galois::steal(), galois::no_stats());
+        });
     inspectionTimer.stop();
 
     uint64_t allBytesRead = bufGraph.getBytesRead();
@@ -1614,27 +1802,31 @@ private:
     galois::StatTimer timer("EdgeLoading", GRNAME);
     timer.start();
 
-    galois::do_all(
-        galois::iterate(base_DistGraph::gid2host[base_DistGraph::id].first,
-                        base_DistGraph::gid2host[base_DistGraph::id].second),
-        [&](size_t n) {
-          auto ii       = bGraph.edgeBegin(n);
-          auto ee       = bGraph.edgeEnd(n);
-          uint32_t lsrc = this->G2LEdgeCut(n, globalOffset);
-          uint64_t cur =
-              *graph.edge_begin(lsrc, galois::MethodFlag::UNPROTECTED);
-          for (; ii < ee; ++ii) {
-            auto gdst           = bGraph.edgeDestination(*ii);
-            decltype(gdst) ldst = this->G2LEdgeCut(gdst, globalOffset);
-            auto gdata          = bGraph.edgeData(*ii);
-            graph.constructEdge(cur++, ldst, gdata);
-          }
-          assert(cur == (*graph.edge_end(lsrc)));
-        },
+    forEachEdgeWindow(
+        bGraph, base_DistGraph::gid2host[base_DistGraph::id].first,
+        base_DistGraph::gid2host[base_DistGraph::id].second,
+        [&](uint64_t windowBegin, uint64_t windowEnd) {
+          galois::do_all(
+              galois::iterate(windowBegin, windowEnd),
+              [&](size_t n) {
+                auto ii       = bGraph.edgeBegin(n);
+                auto ee       = bGraph.edgeEnd(n);
+                uint32_t lsrc = this->G2LEdgeCut(n, globalOffset);
+                uint64_t cur =
+                    *graph.edge_begin(lsrc, galois::MethodFlag::UNPROTECTED);
+                for (; ii < ee; ++ii) {
+                  auto gdst           = bGraph.edgeDestination(*ii);
+                  decltype(gdst) ldst = this->G2LEdgeCut(gdst, globalOffset);
+                  auto gdata          = bGraph.edgeData(*ii);
+                  graph.constructEdge(cur++, ldst, gdata);
+                }
+                assert(cur == (*graph.edge_end(lsrc)));
+              },
 #if MORE_DIST_STATS
-        galois::loopname("EdgeLoadingLoop"),
+              galois::loopname("EdgeLoadingLoop"),
 #endif
-        galois::steal(), galois::no_stats());
+              galois::steal(), galois::no_stats());
+        });
 
     timer.stop();
     galois::gPrint("[", base_DistGraph::id,
@@ -1666,26 +1858,30 @@ private:
     galois::StatTimer timer("EdgeLoading", GRNAME);
     timer.start();
 
-    galois::do_all(
-        galois::iterate(base_DistGraph::gid2host[base_DistGraph::id].first,
-                        base_DistGraph::gid2host[base_DistGraph::id].second),
-        [&](size_t n) {
-          auto ii       = bGraph.edgeBegin(n);
-          auto ee       = bGraph.edgeEnd(n);
-          uint32_t lsrc = this->G2LEdgeCut(n, globalOffset);
-          uint64_t cur =
-              *graph.edge_begin(lsrc, galois::MethodFlag::UNPROTECTED);
-          for (; ii < ee; ++ii) {
-            auto gdst           = bGraph.edgeDestination(*ii);
-            decltype(gdst) ldst = this->G2LEdgeCut(gdst, globalOffset);
-            graph.constructEdge(cur++, ldst);
-          }
-          assert(cur == (*graph.edge_end(lsrc)));
-        },
+    forEachEdgeWindow(
+        bGraph, base_DistGraph::gid2host[base_DistGraph::id].first,
+        base_DistGraph::gid2host[base_DistGraph::id].second,
+        [&](uint64_t windowBegin, uint64_t windowEnd) {
+          galois::do_all(
+              galois::iterate(windowBegin, windowEnd),
+              [&](size_t n) {
+                auto ii       = bGraph.edgeBegin(n);
+                auto ee       = bGraph.edgeEnd(n);
+                uint32_t lsrc = this->G2LEdgeCut(n, globalOffset);
+                uint64_t cur =
+                    *graph.edge_begin(lsrc, galois::MethodFlag::UNPROTECTED);
+                for (; ii < ee; ++ii) {
+                  auto gdst           = bGraph.edgeDestination(*ii);
+                  decltype(gdst) ldst = this->G2LEdgeCut(gdst, globalOffset);
+                  graph.constructEdge(cur++, ldst);
+                }
+                assert(cur == (*graph.edge_end(lsrc)));
+              },
 #if MORE_DIST_STATS
-        galois::loopname("EdgeLoadingLoop"),
+              galois::loopname("EdgeLoadingLoop"),
 #endif
-        galois::steal(), galois::no_stats());
+              galois::steal(), galois::no_stats());
+        });
 
     timer.stop();
     galois::gPrint("[", base_DistGraph::id,
@@ -1781,55 +1977,60 @@ private:
           syncRound, _edgeStateRounds);
       // TODO maybe edge range this?
 
-      galois::do_all(
-          // iterate over my read nodes
-          galois::iterate(beginNode, endNode),
-          [&](size_t src) {
-            auto ee            = bufGraph.edgeBegin(src);
-            auto ee_end        = bufGraph.edgeEnd(src);
-            uint64_t numEdgesL = std::distance(ee, ee_end);
-
-            for (; ee != ee_end; ee++) {
-              uint32_t dst         = bufGraph.edgeDestination(*ee);
-              uint32_t hostBelongs = -1;
-              hostBelongs = graphPartitioner->getEdgeOwner(src, dst, numEdgesL);
-              if (_edgeStateRounds > 1) {
-                hostLoads[hostBelongs] += 1;
-              }
-
-              numOutgoingEdges[hostBelongs][src - globalOffset] += 1;
-              hostHasOutgoing.set(hostBelongs);
-              bool hostIsMasterOfDest =
-                  (hostBelongs == graphPartitioner->retrieveMaster(dst));
-
-              // this means a mirror must be created for destination node on
-              // that host since it will not be created otherwise
-              if (!hostIsMasterOfDest) {
-                auto& bitsetStatus = indicatorVars[hostBelongs];
-
-                // initialize the bitset if necessary
-                if (bitsetStatus == 0) {
-                  char expected = 0;
-                  bool result =
-                      bitsetStatus.compare_exchange_strong(expected, 1);
-                  // i swapped successfully, therefore do allocation
-                  if (result) {
-                    hasIncomingEdge[hostBelongs].resize(globalNodes);
-                    hasIncomingEdge[hostBelongs].reset();
-                    bitsetStatus = 2;
+      forEachEdgeWindow(
+          bufGraph, beginNode, endNode,
+          [&](uint64_t windowBegin, uint64_t windowEnd) {
+            galois::do_all(
+                // iterate over my read nodes
+                galois::iterate(windowBegin, windowEnd),
+                [&](size_t src) {
+                  auto ee            = bufGraph.edgeBegin(src);
+                  auto ee_end        = bufGraph.edgeEnd(src);
+                  uint64_t numEdgesL = std::distance(ee, ee_end);
+
+                  for (; ee != ee_end; ee++) {
+                    uint32_t dst         = bufGraph.edgeDestination(*ee);
+                    uint32_t hostBelongs = -1;
+                    hostBelongs =
+                        graphPartitioner->getEdgeOwner(src, dst, numEdgesL);
+                    if (_edgeStateRounds > 1) {
+                      hostLoads[hostBelongs] += 1;
+                    }
+
+                    numOutgoingEdges[hostBelongs][src - globalOffset] += 1;
+                    hostHasOutgoing.set(hostBelongs);
+                    bool hostIsMasterOfDest =
+                        (hostBelongs == graphPartitioner->retrieveMaster(dst));
+
+                    // this means a mirror must be created for destination node
+                    // on that host since it will not be created otherwise
+                    if (!hostIsMasterOfDest) {
+                      auto& bitsetStatus = indicatorVars[hostBelongs];
+
+                      // initialize the bitset if necessary
+                      if (bitsetStatus == 0) {
+                        char expected = 0;
+                        bool result =
+                            bitsetStatus.compare_exchange_strong(expected, 1);
+                        // i swapped successfully, therefore do allocation
+                        if (result) {
+                          hasIncomingEdge[hostBelongs].resize(globalNodes);
+                          hasIncomingEdge[hostBelongs].reset();
+                          bitsetStatus = 2;
+                        }
+                      }
+                      // until initialized, loop
+                      while (indicatorVars[hostBelongs] != 2)
+                        ;
+                      hasIncomingEdge[hostBelongs].set(dst);
+                    }
                   }
-                }
-                // until initialized, loop
-                while (indicatorVars[hostBelongs] != 2)
-                  ;
-                hasIncomingEdge[hostBelongs].set(dst);
-              }
-            }
-          },
+                },
 #if MORE_DIST_STATS
-          galois::loopname("AssignEdges"),
+                galois::loopname("AssignEdges"),
 #endif
-          galois::steal(), galois::no_stats());
+                galois::steal(), galois::no_stats());
+          });
       syncEdgeLoad();
     }
   }
@@ -2649,92 +2850,96 @@ private:
           _edgeStateRounds);
 
       // Go over assigned nodes and distribute edges.
-      galois::do_all(
-          galois::iterate(beginNode, endNode),
-          [&](uint64_t src) {
-            uint32_t lsrc    = 0;
-            uint64_t curEdge = 0;
-            if (base_DistGraph::isLocal(src)) {
-              lsrc = this->G2L(src);
-              curEdge =
-                  *graph.edge_begin(lsrc, galois::MethodFlag::UNPROTECTED);
-            }
-
-            auto ee            = bufGraph.edgeBegin(src);
-            auto ee_end        = bufGraph.edgeEnd(src);
-            uint64_t numEdgesL = std::distance(ee, ee_end);
-            auto& gdst_vec     = *gdst_vecs.getLocal();
-            auto& gdata_vec    = *gdata_vecs.getLocal();
-
-            for (unsigned i = 0; i < numHosts; ++i) {
-              gdst_vec[i].clear();
-              gdata_vec[i].clear();
-              gdst_vec[i].reserve(numEdgesL);
-              // gdata_vec[i].reserve(numEdgesL);
-            }
-
-            for (; ee != ee_end; ++ee) {
-              uint32_t gdst = bufGraph.edgeDestination(*ee);
-              auto gdata    = bufGraph.edgeData(*ee);
+      forEachEdgeWindow(
+          bufGraph, beginNode, endNode,
+          [&](uint64_t windowBegin, uint64_t windowEnd) {
+            galois::do_all(
+                galois::iterate(windowBegin, windowEnd),
+                [&](uint64_t src) {
+                  uint32_t lsrc    = 0;
+                  uint64_t curEdge = 0;
+                  if (base_DistGraph::isLocal(src)) {
+                    lsrc = this->G2L(src);
+                    curEdge = *graph.edge_begin(
+                        lsrc, galois::MethodFlag::UNPROTECTED);
+                  }
 
-              uint32_t hostBelongs =
-                  graphPartitioner->getEdgeOwner(src, gdst, numEdgesL);
-              if (_edgeStateRounds > 1) {
-                hostLoads[hostBelongs] += 1;
-              }
+                  auto ee            = bufGraph.edgeBegin(src);
+                  auto ee_end        = bufGraph.edgeEnd(src);
+                  uint64_t numEdgesL = std::distance(ee, ee_end);
+                  auto& gdst_vec     = *gdst_vecs.getLocal();
+                  auto& gdata_vec    = *gdata_vecs.getLocal();
+
+                  for (unsigned i = 0; i < numHosts; ++i) {
+                    gdst_vec[i].clear();
+                    gdata_vec[i].clear();
+                    gdst_vec[i].reserve(numEdgesL);
+                    // gdata_vec[i].reserve(numEdgesL);
+                  }
 
-              if (hostBelongs == id) {
-                // edge belongs here, construct on self
-                assert(base_DistGraph::isLocal(src));
-                uint32_t ldst = this->G2L(gdst);
-                graph.constructEdge(curEdge++, ldst, gdata);
-                // TODO
-                // if ldst is an outgoing mirror, this is vertex cut
-              } else {
-                // add to host vector to send out later
-                gdst_vec[hostBelongs].push_back(gdst);
-                gdata_vec[hostBelongs].push_back(gdata);
-              }
-            }
+                  for (; ee != ee_end; ++ee) {
+                    uint32_t gdst = bufGraph.edgeDestination(*ee);
+                    auto gdata    = bufGraph.edgeData(*ee);
+
+                    uint32_t hostBelongs =
+                        graphPartitioner->getEdgeOwner(src, gdst, numEdgesL);
+                    if (_edgeStateRounds > 1) {
+                      hostLoads[hostBelongs] += 1;
+                    }
+
+                    if (hostBelongs == id) {
+                      // edge belongs here, construct on self
+                      assert(base_DistGraph::isLocal(src));
+                      uint32_t ldst = this->G2L(gdst);
+                      graph.constructEdge(curEdge++, ldst, gdata);
+                      // TODO
+                      // if ldst is an outgoing mirror, this is vertex cut
+                    } else {
+                      // add to host vector to send out later
+                      gdst_vec[hostBelongs].push_back(gdst);
+                      gdata_vec[hostBelongs].push_back(gdata);
+                    }
+                  }
 
-            // make sure all edges accounted for if local
-            if (base_DistGraph::isLocal(src)) {
-              assert(curEdge == (*graph.edge_end(lsrc)));
-            }
+                  // make sure all edges accounted for if local
+                  if (base_DistGraph::isLocal(src)) {
+                    assert(curEdge == (*graph.edge_end(lsrc)));
+                  }
 
-            // send
-            for (uint32_t h = 0; h < numHosts; ++h) {
-              if (h == id)
-                continue;
-
-              if (gdst_vec[h].size() > 0) {
-                auto& b = (*sendBuffers.getLocal())[h];
-                galois::runtime::gSerialize(b, src);
-                galois::runtime::gSerialize(b, gdst_vec[h]);
-                galois::runtime::gSerialize(b, gdata_vec[h]);
-
-                // send if over limit
-                if (b.size() > edgePartitionSendBufSize) {
-                  messagesSent += 1;
-                  bytesSent.update(b.size());
-                  maxBytesSent.update(b.size());
-
-                  net.sendTagged(h, galois::runtime::evilPhase, b);
-                  b.getVec().clear();
-                  b.getVec().reserve(edgePartitionSendBufSize * 1.25);
-                }
-              }
-            }
+                  // send
+                  for (uint32_t h = 0; h < numHosts; ++h) {
+                    if (h == id)
+                      continue;
+
+                    if (gdst_vec[h].size() > 0) {
+                      auto& b = (*sendBuffers.getLocal())[h];
+                      galois::runtime::gSerialize(b, src);
+                      galois::runtime::gSerialize(b, gdst_vec[h]);
+                      galois::runtime::gSerialize(b, gdata_vec[h]);
+
+                      // send if over limit
+                      if (b.size() > sendBufSizeLimit) {
+                        messagesSent += 1;
+                        bytesSent.update(b.size());
+                        maxBytesSent.update(b.size());
+
+                        net.sendTagged(h, galois::runtime::evilPhase, b);
+                        b.getVec().clear();
+                        b.getVec().reserve(sendBufSizeLimit * 1.25);
+                      }
+                    }
+                  }
 
-            // overlap receives
-            auto buffer =
-                net.recieveTagged(galois::runtime::evilPhase, nullptr);
-            this->processReceivedEdgeBuffer(buffer, graph, receivedNodes);
-          },
+                  // overlap receives
+                  auto buffer =
+                      net.recieveTagged(galois::runtime::evilPhase, nullptr);
+                  this->processReceivedEdgeBuffer(buffer, graph, receivedNodes);
+                },
 #if MORE_DIST_STATS
-          galois::loopname("EdgeLoadingLoop"),
+                galois::loopname("EdgeLoadingLoop"),
 #endif
-          galois::steal(), galois::no_stats());
+                galois::steal(), galois::no_stats());
+          });
       syncEdgeLoad();
       // printEdgeLoad();
     }
@@ -2802,85 +3007,89 @@ private:
           _edgeStateRounds);
 
       // Go over assigned nodes and distribute edges.
-      galois::do_all(
-          galois::iterate(beginNode, endNode),
-          [&](uint64_t src) {
-            uint32_t lsrc    = 0;
-            uint64_t curEdge = 0;
-            if (base_DistGraph::isLocal(src)) {
-              lsrc = this->G2L(src);
-              curEdge =
-                  *graph.edge_begin(lsrc, galois::MethodFlag::UNPROTECTED);
-            }
-
-            auto ee            = bufGraph.edgeBegin(src);
-            auto ee_end        = bufGraph.edgeEnd(src);
-            uint64_t numEdgesL = std::distance(ee, ee_end);
-            auto& gdst_vec     = *gdst_vecs.getLocal();
+      forEachEdgeWindow(
+          bufGraph, beginNode, endNode,
+          [&](uint64_t windowBegin, uint64_t windowEnd) {
+            galois::do_all(
+                galois::iterate(windowBegin, windowEnd),
+                [&](uint64_t src) {
+                  uint32_t lsrc    = 0;
+                  uint64_t curEdge = 0;
+                  if (base_DistGraph::isLocal(src)) {
+                    lsrc = this->G2L(src);
+                    curEdge = *graph.edge_begin(
+                        lsrc, galois::MethodFlag::UNPROTECTED);
+                  }
 
-            for (unsigned i = 0; i < numHosts; ++i) {
-              gdst_vec[i].clear();
-              // gdst_vec[i].reserve(numEdgesL);
-            }
+                  auto ee            = bufGraph.edgeBegin(src);
+                  auto ee_end        = bufGraph.edgeEnd(src);
+                  uint64_t numEdgesL = std::distance(ee, ee_end);
+                  auto& gdst_vec     = *gdst_vecs.getLocal();
 
-            for (; ee != ee_end; ++ee) {
-              uint32_t gdst = bufGraph.edgeDestination(*ee);
-              uint32_t hostBelongs =
-                  graphPartitioner->getEdgeOwner(src, gdst, numEdgesL);
-              if (_edgeStateRounds > 1) {
-                hostLoads[hostBelongs] += 1;
-              }
+                  for (unsigned i = 0; i < numHosts; ++i) {
+                    gdst_vec[i].clear();
+                    // gdst_vec[i].reserve(numEdgesL);
+                  }
 
-              if (hostBelongs == id) {
-                // edge belongs here, construct on self
-                assert(base_DistGraph::isLocal(src));
-                uint32_t ldst = this->G2L(gdst);
-                graph.constructEdge(curEdge++, ldst);
-                // TODO
-                // if ldst is an outgoing mirror, this is vertex cut
-              } else {
-                // add to host vector to send out later
-                gdst_vec[hostBelongs].push_back(gdst);
-              }
-            }
+                  for (; ee != ee_end; ++ee) {
+                    uint32_t gdst = bufGraph.edgeDestination(*ee);
+                    uint32_t hostBelongs =
+                        graphPartitioner->getEdgeOwner(src, gdst, numEdgesL);
+                    if (_edgeStateRounds > 1) {
+                      hostLoads[hostBelongs] += 1;
+                    }
+
+                    if (hostBelongs == id) {
+                      // edge belongs here, construct on self
+                      assert(base_DistGraph::isLocal(src));
+                      uint32_t ldst = this->G2L(gdst);
+                      graph.constructEdge(curEdge++, ldst);
+                      // TODO
+                      // if ldst is an outgoing mirror, this is vertex cut
+                    } else {
+                      // add to host vector to send out later
+                      gdst_vec[hostBelongs].push_back(gdst);
+                    }
+                  }
 
-            // make sure all edges accounted for if local
-            if (base_DistGraph::isLocal(src)) {
-              assert(curEdge == (*graph.edge_end(lsrc)));
-            }
+                  // make sure all edges accounted for if local
+                  if (base_DistGraph::isLocal(src)) {
+                    assert(curEdge == (*graph.edge_end(lsrc)));
+                  }
 
-            // send
-            for (uint32_t h = 0; h < numHosts; ++h) {
-              if (h == id)
-                continue;
-
-              if (gdst_vec[h].size() > 0) {
-                auto& b = (*sendBuffers.getLocal())[h];
-                galois::runtime::gSerialize(b, src);
-                galois::runtime::gSerialize(b, gdst_vec[h]);
-
-                // send if over limit
-                if (b.size() > edgePartitionSendBufSize) {
-                  messagesSent += 1;
-                  bytesSent.update(b.size());
-                  maxBytesSent.update(b.size());
-
-                  net.sendTagged(h, galois::runtime::evilPhase, b);
-                  b.getVec().clear();
-                  b.getVec().reserve(edgePartitionSendBufSize * 1.25);
-                }
-              }
-            }
+                  // send
+                  for (uint32_t h = 0; h < numHosts; ++h) {
+                    if (h == id)
+                      continue;
+
+                    if (gdst_vec[h].size() > 0) {
+                      auto& b = (*sendBuffers.getLocal())[h];
+                      galois::runtime::gSerialize(b, src);
+                      galois::runtime::gSerialize(b, gdst_vec[h]);
+
+                      // send if over limit
+                      if (b.size() > sendBufSizeLimit) {
+                        messagesSent += 1;
+                        bytesSent.update(b.size());
+                        maxBytesSent.update(b.size());
+
+                        net.sendTagged(h, galois::runtime::evilPhase, b);
+                        b.getVec().clear();
+                        b.getVec().reserve(sendBufSizeLimit * 1.25);
+                      }
+                    }
+                  }
 
-            // overlap receives
-            auto buffer =
-                net.recieveTagged(galois::runtime::evilPhase, nullptr);
-            this->processReceivedEdgeBuffer(buffer, graph, receivedNodes);
-          },
+                  // overlap receives
+                  auto buffer =
+                      net.recieveTagged(galois::runtime::evilPhase, nullptr);
+                  this->processReceivedEdgeBuffer(buffer, graph, receivedNodes);
+                },
 #if MORE_DIST_STATS
-          galois::loopname("EdgeLoading"),
+                galois::loopname("EdgeLoading"),
 #endif
-          galois::steal(), galois::no_stats());
+                galois::steal(), galois::no_stats());
+          });
       syncEdgeLoad();
       // printEdgeLoad();
     }
@@ -32,9 +32,15 @@
 #include "galois/AtomicHelpers.h"
 #include "galois/runtime/LWCI.h"
 #include "galois/runtime/DistStats.h"
+#include "galois/runtime/Collectives.h"
+
+#include <functional>
+#include <vector>
 
 namespace galois {
 
+class DGReduceBatch;
+
 /**
  * Distributed sum-reducer for getting the sum of some value across multiple
  * hosts.
@@ -90,6 +96,9 @@ class DGAccumulator {
   }
 #endif
 
+  //! lets batched reductions set the reduced value
+  friend class DGReduceBatch;
+
 public:
   //! Default constructor
   DGAccumulator() {}
@@ -245,6 +254,9 @@ class DGReduceMax {
   }
 #endif
 
+  //! lets batched reductions set the reduced value
+  friend class DGReduceBatch;
+
 public:
   /**
    * Default constructor; initializes everything to 0.
@@ -380,6 +392,9 @@ class DGReduceMin {
   }
 #endif
 
+  //! lets batched reductions set the reduced value
+  friend class DGReduceBatch;
+
 public:
   /**
    * Default constructor; initializes everything to the max value of the type.
@@ -459,5 +474,130 @@ public:
   }
 };
 
+/**
+ * Reduces several distributed reducers with a single collective instead of
+ * one collective per reducer. Reducers are added once and the batch can then
+ * be reduced as often as needed (e.g. every round): each reduction reads the
+ * local values of the reducers at that time and leaves the reduced values in
+ * them as if their own reduce had been called.
+ *
+ * The collective (galois::runtime::HierarchicalAllreduce) aggregates the
+ * values of the hosts of each node over shared memory before reducing across
+ * nodes. Hosts must add the same reducers in the same order.
+ */
+class DGReduceBatch {
+  //! A reducer in the batch
+  struct Member {
+    //! Gets the local value of the reducer
+    std::function<galois::runtime::BatchedValue()> local;
+    //! Sets the reduced value of the reducer
+    std::function<void(const galois::runtime::BatchedValue&)> global;
+    //! Reduces the reducer on its own
+    std::function<void()> reduceAlone;
+  };
+
+  std::vector<Member> members;
+  std::vector<galois::runtime::BatchedValue> values;
+#ifndef GALOIS_USE_LCI
+  galois::runtime::HierarchicalAllreduce collective;
+#endif
+
+  template <typename Ty, typename ReducerTy>
+  DGReduceBatch& addMember(galois::runtime::BatchedOp op, ReducerTy& reducer) {
+    members.push_back(Member{
+        [op, &reducer]() {
+          return galois::runtime::BatchedValue::make(op, reducer.read_local());
+        },
+        [&reducer](const galois::runtime::BatchedValue& val) {
+          reducer.global_mdata = val.template get<Ty>();
+        },
+        [&reducer]() { reducer.reduce(); }});
+    return *this;
+  }
+
+public:
+  /**
+   * Adds a sum-reducer to the batch.
+   *
+   * @param reducer Reducer to add; must outlive the batch
+   * @returns reference to this object
+   */
+  template <typename Ty>
+  DGReduceBatch& add(DGAccumulator<Ty>& reducer) {
+    return addMember<Ty>(galois::runtime::BatchedOp::sum, reducer);
+  }
+
+  /**
+   * Adds a max-reducer to the batch.
+   *
+   * @param reducer Reducer to add; must outlive the batch
+   * @returns reference to this object
+   */
+  template <typename Ty>
+  DGReduceBatch& add(DGReduceMax<Ty>& reducer) {
+    return addMember<Ty>(galois::runtime::BatchedOp::max, reducer);
+  }
+
+  /**
+   * Adds a min-reducer to the batch.
+   *
+   * @param reducer Reducer to add; must outlive the batch
+   * @returns reference to this object
+   */
+  template <typename Ty>
+  DGReduceBatch& add(DGReduceMin<Ty>& reducer) {
+    return addMember<Ty>(galois::runtime::BatchedOp::min, reducer);
+  }
+
+  /**
+   * Begins reducing all reducers of the batch across all hosts. Work that
+   * does not read the reduced values can be done until wait is called.
+   */
+  void start() {
+#ifdef GALOIS_USE_LCI
+    for (auto& member : members) {
+      member.reduceAlone();
+    }
+#else
+    values.clear();
+    for (auto& member : members) {
+      values.push_back(member.local());
+    }
+    collective.start(values);
+#endif
+  }
+
+  /**
+   * Finishes the reduction begun by start and sets the reduced value of
+   * every reducer of the batch.
+   */
+  void wait() {
+#ifndef GALOIS_USE_LCI
+    collective.wait();
+    for (size_t i = 0; i < members.size(); ++i) {
+      members[i].global(values[i]);
+    }
+#endif
+  }
+
+  /**
+   * Reduces all reducers of the batch across all hosts; their reduced values
+   * can then be read with read.
+   *
+   * @param runID optional argument used to create a statistics timer
+   * for later reporting
+   */
+  void reduce(std::string runID = std::string()) {
+    std::string timer_str("ReduceDGBatch_" + runID);
+
+    galois::CondStatTimer<GALOIS_COMM_STATS> reduceTimer(timer_str.c_str(),
+                                                         "DGReduceBatch");
+    reduceTimer.start();
+    start();
+    wait();
+    reduceTimer.stop();
+  }
+};
+
 } // namespace galois
 #endif
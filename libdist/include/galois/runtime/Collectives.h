@@ -0,0 +1,149 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file Collectives.h
+ *
+ * Contains the topology-aware collective used to reduce a batch of values of
+ * different types and reduction operations across all hosts at once.
+ */
+#ifndef GALOIS_RUNTIME_COLLECTIVES_H
+#define GALOIS_RUNTIME_COLLECTIVES_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#ifndef GALOIS_USE_LCI
+#include <mpi.h>
+#endif
+
+namespace galois {
+namespace runtime {
+
+//! Reduction operation applied to a value of a batch; bitOr only applies to
+//! unsigned integers
+enum class BatchedOp : uint8_t { sum, max, min, bitOr };
+
+//! Representation of a value of a batch
+enum class BatchedKind : uint8_t { signedInt, unsignedInt, floating };
+
+/**
+ * One value of a batched reduction along with how to reduce it. Integers are
+ * widened to 64 bits and floating point values to double, so values of
+ * different types can share one collective.
+ */
+struct BatchedValue {
+  BatchedOp op;     //!< reduction operation
+  BatchedKind kind; //!< which member of the union holds the value
+  union {
+    int64_t s;  //!< value if kind is signedInt
+    uint64_t u; //!< value if kind is unsignedInt
+    double f;   //!< value if kind is floating
+  };
+
+  /**
+   * Wraps a value for a batched reduction.
+   *
+   * @tparam Ty arithmetic type of the value
+   * @param _op Reduction operation to apply to the value
+   * @param val Value to wrap
+   */
+  template <typename Ty>
+  static BatchedValue make(BatchedOp _op, Ty val) {
+    static_assert(std::is_arithmetic<Ty>::value,
+                  "only arithmetic types can be batched");
+    BatchedValue b;
+    b.op = _op;
+    if (std::is_floating_point<Ty>::value) {
+      b.kind = BatchedKind::floating;
+      b.f    = static_cast<double>(val);
+    } else if (std::is_signed<Ty>::value) {
+      b.kind = BatchedKind::signedInt;
+      b.s    = static_cast<int64_t>(val);
+    } else {
+      b.kind = BatchedKind::unsignedInt;
+      b.u    = static_cast<uint64_t>(val);
+    }
+    return b;
+  }
+
+  /**
+   * Unwraps a reduced value back into its original type.
+   *
+   * @tparam Ty type the value was wrapped from
+   */
+  template <typename Ty>
+  Ty get() const {
+    switch (kind) {
+    case BatchedKind::floating:
+      return static_cast<Ty>(f);
+    case BatchedKind::signedInt:
+      return static_cast<Ty>(s);
+    default:
+      return static_cast<Ty>(u);
+    }
+  }
+};
+
+#ifndef GALOIS_USE_LCI
+/**
+ * Allreduce of a batch of values that is aware of the placement of hosts on
+ * nodes. Hosts on the same node first reduce their batches to a node leader
+ * over shared memory; node leaders then run a non-blocking allreduce among
+ * themselves, and each leader finally broadcasts the result to the hosts of
+ * its node. With one host per node this is a single non-blocking allreduce.
+ *
+ * start and wait are collective and must be called by all hosts in the same
+ * order with batches of the same length and layout. Work that does not
+ * depend on the result can be done between them to overlap it with the
+ * inter-node reduction.
+ */
+class HierarchicalAllreduce {
+  std::vector<BatchedValue>* values = nullptr;
+  MPI_Request request               = MPI_REQUEST_NULL;
+
+public:
+  /**
+   * Begins reducing a batch of values in place.
+   *
+   * @param _values Values to reduce; must not be touched until wait returns
+   */
+  void start(std::vector<BatchedValue>& _values);
+
+  /**
+   * Finishes the reduction begun by start; the batch then holds the values
+   * reduced across all hosts.
+   */
+  void wait();
+};
+
+namespace internal {
+/**
+ * Frees the communicators, datatype and operation created for hierarchical
+ * collectives (if any). Must be called before MPI is finalized.
+ */
+void freeCollectives();
+} // namespace internal
+#endif
+
+} // namespace runtime
+} // namespace galois
+
+#endif
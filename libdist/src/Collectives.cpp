@@ -0,0 +1,160 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file libdist/src/Collectives.cpp
+ *
+ * Contains the implementation of the hierarchical (node leader) allreduce of
+ * batched values.
+ */
+
+#ifndef GALOIS_USE_LCI
+#include "galois/runtime/Collectives.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+
+namespace {
+
+//! Communicators, datatype and operation used by hierarchical collectives;
+//! created on first use since creating them is collective
+struct CollectiveState {
+  bool initialized = false;
+  //! Hosts on the same (shared memory) node
+  MPI_Comm nodeComm = MPI_COMM_NULL;
+  //! Leaders (rank 0 of nodeComm) of all nodes; null on other hosts
+  MPI_Comm leaderComm = MPI_COMM_NULL;
+  //! Number of hosts on this node
+  int nodeSize = 1;
+  //! BatchedValue as an MPI datatype
+  MPI_Datatype valueType = MPI_DATATYPE_NULL;
+  //! Reduces BatchedValues according to their op and kind
+  MPI_Op valueOp = MPI_OP_NULL;
+};
+
+CollectiveState collectives;
+
+template <typename T>
+T applyOp(galois::runtime::BatchedOp op, T a, T b) {
+  switch (op) {
+  case galois::runtime::BatchedOp::sum:
+    return a + b;
+  case galois::runtime::BatchedOp::max:
+    return std::max(a, b);
+  default:
+    return std::min(a, b);
+  }
+}
+
+void reduceBatchedValues(void* in, void* inout, int* len, MPI_Datatype*) {
+  using galois::runtime::BatchedKind;
+  using galois::runtime::BatchedValue;
+  auto* src = static_cast<BatchedValue*>(in);
+  auto* dst = static_cast<BatchedValue*>(inout);
+  for (int i = 0; i < *len; ++i) {
+    if (dst[i].op == galois::runtime::BatchedOp::bitOr) {
+      dst[i].u |= src[i].u;
+      continue;
+    }
+    switch (dst[i].kind) {
+    case BatchedKind::floating:
+      dst[i].f = applyOp(dst[i].op, dst[i].f, src[i].f);
+      break;
+    case BatchedKind::signedInt:
+      dst[i].s = applyOp(dst[i].op, dst[i].s, src[i].s);
+      break;
+    default:
+      dst[i].u = applyOp(dst[i].op, dst[i].u, src[i].u);
+      break;
+    }
+  }
+}
+
+void initializeCollectives() {
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                      MPI_INFO_NULL, &collectives.nodeComm);
+  int nodeRank;
+  MPI_Comm_rank(collectives.nodeComm, &nodeRank);
+  MPI_Comm_size(collectives.nodeComm, &collectives.nodeSize);
+  MPI_Comm_split(MPI_COMM_WORLD, (nodeRank == 0) ? 0 : MPI_UNDEFINED, rank,
+                 &collectives.leaderComm);
+
+  MPI_Type_contiguous(sizeof(galois::runtime::BatchedValue), MPI_BYTE,
+                      &collectives.valueType);
+  MPI_Type_commit(&collectives.valueType);
+  MPI_Op_create(&reduceBatchedValues, 1, &collectives.valueOp);
+  collectives.initialized = true;
+}
+
+} // namespace
+
+void galois::runtime::HierarchicalAllreduce::start(
+    std::vector<BatchedValue>& _values) {
+  if (!collectives.initialized) {
+    initializeCollectives();
+  }
+  values    = &_values;
+  int count = static_cast<int>(values->size());
+
+  // aggregate the values of this node on its leader
+  if (collectives.nodeSize > 1) {
+    if (collectives.leaderComm != MPI_COMM_NULL) {
+      MPI_Reduce(MPI_IN_PLACE, values->data(), count, collectives.valueType,
+                 collectives.valueOp, 0, collectives.nodeComm);
+    } else {
+      MPI_Reduce(values->data(), nullptr, count, collectives.valueType,
+                 collectives.valueOp, 0, collectives.nodeComm);
+    }
+  }
+
+  if (collectives.leaderComm != MPI_COMM_NULL) {
+    MPI_Iallreduce(MPI_IN_PLACE, values->data(), count, collectives.valueType,
+                   collectives.valueOp, collectives.leaderComm, &request);
+  }
+}
+
+void galois::runtime::HierarchicalAllreduce::wait() {
+  if (!values) {
+    GALOIS_DIE("HierarchicalAllreduce::wait called without start");
+  }
+  if (request != MPI_REQUEST_NULL) {
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+  }
+  if (collectives.nodeSize > 1) {
+    MPI_Bcast(values->data(), static_cast<int>(values->size()),
+              collectives.valueType, 0, collectives.nodeComm);
+  }
+  values = nullptr;
+}
+
+void galois::runtime::internal::freeCollectives() {
+  if (!collectives.initialized) {
+    return;
+  }
+  if (collectives.leaderComm != MPI_COMM_NULL) {
+    MPI_Comm_free(&collectives.leaderComm);
+  }
+  MPI_Comm_free(&collectives.nodeComm);
+  MPI_Type_free(&collectives.valueType);
+  MPI_Op_free(&collectives.valueOp);
+  collectives.initialized = false;
+}
+#endif
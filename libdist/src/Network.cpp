@@ -27,6 +27,7 @@
 #include "galois/runtime/Tracer.h"
 #include "galois/runtime/Network.h"
 #include "galois/runtime/NetworkIO.h"
+#include "galois/runtime/Collectives.h"
 
 #include <iostream>
 #include <mutex>
@@ -56,6 +57,9 @@ void NetworkInterface::initializeMPI() {
 }
 
 void NetworkInterface::finalizeMPI() {
+#ifndef GALOIS_USE_LCI
+  internal::freeCollectives();
+#endif
   int finalizeSuccess = MPI_Finalize();
 
   if (finalizeSuccess != MPI_SUCCESS) {
@@ -373,6 +373,34 @@ public:
     graphFile.close();
   }
 
+  /**
+   * Frees the currently loaded buffers and loads a different node/edge range
+   * of the same graph in their place. Unlike resetAndFree followed by
+   * loadPartialGraph, read counters are kept so that they account for all
+   * ranges read so far.
+   *
+   * @param filename name of graph to load; should be in Galois binary graph
+   * format
+   * @param nodeStart First node to load
+   * @param nodeEnd Last node to load, non-inclusive
+   * @param edgeStart First edge to load; should correspond to first edge of
+   * first node
+   * @param edgeEnd Last edge to load, non-inclusive
+   * @param numGlobalNodes Total number of nodes in the graph
+   * @param numGlobalEdges Total number of edges in the graph
+   */
+  void reloadPartialGraph(const std::string& filename, uint64_t nodeStart,
+                          uint64_t nodeEnd, uint64_t edgeStart,
+                          uint64_t edgeEnd, uint64_t numGlobalNodes,
+                          uint64_t numGlobalEdges) {
+    freeMemory();
+    graphLoaded = false;
+    // loadEdgeDest does not touch the offset for an edgeless range
+    edgeOffset = edgeStart;
+    loadPartialGraph(filename, nodeStart, nodeEnd, edgeStart, edgeEnd,
+                     numGlobalNodes, numGlobalEdges);
+  }
+
   //! Edge iterator typedef
   using EdgeIterator = boost::counting_iterator<uint64_t>;
   /**
@@ -33,10 +33,21 @@
 #include "galois/substrate/ThreadPool.h"
 #include "galois/Timer.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace galois::runtime {
 
 namespace internal {
 
+/**
+ * Work-stealing do_all. The chunk_size trait is the largest number of
+ * iterations a thread takes from its range at a time; the size actually used
+ * adapts at runtime: it halves on every thread whenever some thread runs out
+ * of work (so the remaining iterations can be stolen at a finer grain) and
+ * doubles again after a run of chunks taken without a thief contending for
+ * the range.
+ */
 template <typename R, typename F, typename ArgsTuple>
 class DoAllStealingExec {
 
@@ -50,6 +61,8 @@ class DoAllStealingExec {
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
+  //! Number of uncontended chunks after which the chunk size doubles
+  constexpr static const unsigned GROW_AFTER = 16;
 
   struct ThreadContext {
 
@@ -61,28 +74,43 @@ class DoAllStealingExec {
     Diff_ty m_size;
     size_t num_iter;
 
+    // chunk size adaptation; only touched by the owning thread
+    Diff_ty cur_chunk;
+    unsigned quiet;
+    size_t seen_starvations;
+
     // Stats
+    size_t num_chunks;
+    size_t num_shrinks;
 
     ThreadContext()
         : work_mutex(), id(substrate::getThreadPool().getMaxThreads()),
-          shared_beg(), shared_end(), m_size(0), num_iter(0) {
+          shared_beg(), shared_end(), m_size(0), num_iter(0), cur_chunk(1),
+          quiet(0), seen_starvations(0), num_chunks(0), num_shrinks(0) {
       // TODO: fix this initialization problem,
       // see initThread
     }
 
-    ThreadContext(unsigned id, Iter beg, Iter end)
+    ThreadContext(unsigned id, Iter beg, Iter end, Diff_ty chunk_size)
         : work_mutex(), id(id), shared_beg(beg), shared_end(end),
-          m_size(std::distance(beg, end)), num_iter(0) {}
+          m_size(std::distance(beg, end)), num_iter(0), cur_chunk(chunk_size),
+          quiet(0), seen_starvations(0), num_chunks(0), num_shrinks(0) {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    bool doWork(F func, const Diff_ty chunk_size,
+                const std::atomic<size_t>& starvations) {
       Iter beg(shared_beg);
       Iter end(shared_end);
 
       bool didwork = false;
 
-      while (getWork(beg, end, chunk_size)) {
+      while (getWork(beg, end)) {
 
         didwork = true;
+        if (NEED_STATS) {
+          ++num_chunks;
+        }
+        adaptChunk(chunk_size,
+                   starvations.load(std::memory_order_relaxed));
 
         for (; beg != end; ++beg) {
           if (NEED_STATS) {
@@ -114,22 +142,42 @@ class DoAllStealingExec {
     }
 
   private:
-    bool getWork(Iter& priv_beg, Iter& priv_end, const unsigned chunk_size) {
+    //! true if a thief held work_mutex when the last chunk was taken
+    bool contended = false;
+
+    void adaptChunk(const Diff_ty chunk_size, const size_t starvations) {
+      if (starvations != seen_starvations) {
+        seen_starvations = starvations;
+        cur_chunk = std::max<Diff_ty>(cur_chunk / 2, (chunk_size + 15) / 16);
+        quiet     = 0;
+        ++num_shrinks;
+      } else if (contended) {
+        quiet = 0;
+      } else if (++quiet >= GROW_AFTER) {
+        cur_chunk = std::min<Diff_ty>(cur_chunk * 2, chunk_size);
+        quiet     = 0;
+      }
+    }
+
+    bool getWork(Iter& priv_beg, Iter& priv_end) {
       bool succ = false;
 
-      work_mutex.lock();
+      contended = !work_mutex.try_lock();
+      if (contended) {
+        work_mutex.lock();
+      }
       {
         if (hasWorkWeak()) {
           succ = true;
 
           Iter nbeg = shared_beg;
-          if (m_size <= chunk_size) {
+          if (m_size <= cur_chunk) {
             nbeg   = shared_end;
             m_size = 0;
 
           } else {
-            std::advance(nbeg, chunk_size);
-            m_size -= chunk_size;
+            std::advance(nbeg, cur_chunk);
+            m_size -= cur_chunk;
             assert(m_size > 0);
           }
 
@@ -356,6 +404,8 @@ private:
   const char* loopname;
   Diff_ty chunk_size;
   substrate::PerThreadStorage<ThreadContext> workers;
+  //! Number of times a thread ran out of work in its own range
+  std::atomic<size_t> starvations{0};
 
   substrate::TerminationDetection& term;
 
@@ -387,7 +437,7 @@ public:
     unsigned id = substrate::ThreadPool::getTID();
 
     *workers.getLocal(id) =
-        ThreadContext(id, range.local_begin(), range.local_end());
+        ThreadContext(id, range.local_begin(), range.local_end(), chunk_size);
 
     initTime.stop();
   }
@@ -414,13 +464,14 @@ public:
 
       execTime.start();
 
-      if (ctx.doWork(func, chunk_size)) {
+      if (ctx.doWork(func, chunk_size, starvations)) {
         workHappened = true;
       }
 
       execTime.stop();
 
       assert(!ctx.hasWork());
+      starvations.fetch_add(1, std::memory_order_relaxed);
 
       stealTime.start();
       bool stole = trySteal(ctx);
@@ -453,6 +504,10 @@ public:
 
     if (NEED_STATS) {
       galois::runtime::reportStat_Tsum(loopname, "Iterations", ctx.num_iter);
+      // Iterations / Chunks is the average chunk size
+      galois::runtime::reportStat_Tsum(loopname, "Chunks", ctx.num_chunks);
+      galois::runtime::reportStat_Tsum(loopname, "ChunkShrinks",
+                                       ctx.num_shrinks);
     }
   }
 };
@@ -303,6 +303,14 @@ protected:
     return wl.empty();
   }
 
+  void reportWorkListStats(WorkListTy&, ...) {}
+
+  template <typename WL>
+  auto reportWorkListStats(WL& wl, int)
+      -> decltype(wl.reportStats(loopname), void()) {
+    wl.reportStats(loopname);
+  }
+
   template <bool couldAbort, bool isLeader>
   void go() {
 
@@ -356,6 +364,9 @@ protected:
       barrier.wait();
     }
 
+    if (needStats)
+      reportWorkListStats(wl, 0);
+
     if (couldAbort)
       setThreadContext(0);
   }
@@ -23,10 +23,14 @@
 #include "galois/config.h"
 #include "galois/FixedSizeRing.h"
 #include "galois/runtime/Mem.h"
+#include "galois/runtime/Statistics.h"
 #include "galois/substrate/PaddedLock.h"
 #include "galois/worklists/WLCompileCheck.h"
 #include "galois/worklists/WorkListHelpers.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace galois {
 namespace runtime {
 extern unsigned activeThreads;
@@ -54,7 +58,16 @@ struct squeue<false, PS, TQ> {
   int size() { return 0; }
 };
 
-//! Common functionality to all chunked worklists
+/**
+ * Common functionality to all chunked worklists.
+ *
+ * ChunkSize is the capacity of a chunk. The number of items a thread puts
+ * in a chunk before publishing it adapts at runtime between
+ * MinChunkSize and ChunkSize: it starts at ChunkSize, halves whenever some
+ * thread runs out of chunks (so that work reaches idle threads sooner) and
+ * doubles again after a run of chunks popped from the thread's own queue
+ * without stealing and without contention on the queue.
+ */
 template <typename T, template <typename, bool> class QT, bool Distributed,
           bool IsStack, int ChunkSize, bool Concurrent>
 struct ChunkMaster {
@@ -70,6 +83,11 @@ struct ChunkMaster {
   using rethread =
       ChunkMaster<T, QT, Distributed, IsStack, ChunkSize, _Concurrent>;
 
+  //! Smallest number of items a chunk is filled with before it is published
+  static constexpr int MinChunkSize = (ChunkSize + 15) / 16;
+  //! Number of quiet chunk pops after which the fill size doubles
+  static constexpr unsigned GrowAfter = 16;
+
 private:
   class Chunk : public FixedSizeRing<T, ChunkSize>,
                 public QT<Chunk, Concurrent>::ListNode {};
@@ -79,13 +97,29 @@ private:
   struct p {
     Chunk* cur;
     Chunk* next;
-    p() : cur(0), next(0) {}
+    //! items to fill a chunk with before publishing it
+    unsigned fill;
+    //! chunks popped since the last steal, contention or fill change
+    unsigned quiet;
+    //! value of starvations last seen
+    unsigned seenStarvations;
+    //! true while this thread finds no chunks
+    bool starving;
+    // stats
+    size_t chunksPushed;
+    size_t itemsPushed;
+    size_t shrinks;
+    p()
+        : cur(0), next(0), fill(ChunkSize), quiet(0), seenStarvations(0),
+          starving(false), chunksPushed(0), itemsPushed(0), shrinks(0) {}
   };
 
   typedef QT<Chunk, Concurrent> LevelItem;
 
   squeue<Concurrent, substrate::PerThreadStorage, p> data;
   squeue<Distributed, substrate::PerSocketStorage, LevelItem> Q;
+  //! Number of times some thread started to starve
+  std::atomic<unsigned> starvations{0};
 
   Chunk* mkChunk() {
     Chunk* ptr = alloc.allocate(1);
@@ -99,6 +133,9 @@ private:
   }
 
   void pushChunk(Chunk* C) {
+    p& n = data.get();
+    ++n.chunksPushed;
+    n.itemsPushed += C->size();
     LevelItem& I = Q.get();
     I.push(C);
   }
@@ -108,22 +145,65 @@ private:
     return I.pop();
   }
 
+  //! Records that this thread has no items left; only the first of a run of
+  //! empty pops counts as a new starvation
+  void starve(p& n) {
+    if (!n.starving) {
+      n.starving = true;
+      starvations.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  //! Halves the fill size of this thread if some thread started to starve
+  //! since it last looked; returns true if it did
+  bool shrinkFill(p& n) {
+    unsigned seen = starvations.load(std::memory_order_relaxed);
+    if (seen == n.seenStarvations)
+      return false;
+    n.seenStarvations = seen;
+    n.fill            = std::max<unsigned>(n.fill / 2, MinChunkSize);
+    n.quiet           = 0;
+    ++n.shrinks;
+    return true;
+  }
+
+  //! Adapts the fill size of this thread after it popped a chunk
+  void adaptFill(p& n, bool local, bool contended) {
+    n.starving = false;
+    if (shrinkFill(n)) {
+      return;
+    } else if (!local || contended) {
+      n.quiet = 0;
+    } else if (++n.quiet >= GrowAfter) {
+      n.fill  = std::min<unsigned>(n.fill * 2, ChunkSize);
+      n.quiet = 0;
+    }
+  }
+
   Chunk* popChunk() {
-    int id   = Q.myEffectiveID();
-    Chunk* r = popChunkByID(id);
-    if (r)
+    p& n           = data.get();
+    int id         = Q.myEffectiveID();
+    bool contended = Q.get(id).busy();
+    Chunk* r       = popChunkByID(id);
+    if (r) {
+      adaptFill(n, true, contended);
       return r;
+    }
 
     for (int i = id + 1; i < (int)Q.size(); ++i) {
       r = popChunkByID(i);
-      if (r)
+      if (r) {
+        adaptFill(n, false, contended);
         return r;
+      }
     }
 
     for (int i = 0; i < id; ++i) {
       r = popChunkByID(i);
-      if (r)
+      if (r) {
+        adaptFill(n, false, contended);
         return r;
+      }
     }
 
     return 0;
@@ -132,10 +212,13 @@ private:
   template <typename... Args>
   T* emplacei(p& n, Args&&... args) {
     T* retval = 0;
-    if (n.next && (retval = n.next->emplace_back(std::forward<Args>(args)...)))
+    if (n.next && n.next->size() < n.fill &&
+        (retval = n.next->emplace_back(std::forward<Args>(args)...)))
       return retval;
     if (n.next)
       pushChunk(n.next);
+    // producers that never pop from the shared queues see starvation here
+    shrinkFill(n);
     n.next = mkChunk();
     retval = n.next->emplace_back(std::forward<Args>(args)...);
     assert(retval);
@@ -184,6 +267,7 @@ public:
       n.next = popChunk();
       if (n.next && !n.next->empty())
         return &n.next->back();
+      starve(n);
       return NULL;
     } else {
       if (n.cur && !n.cur->empty())
@@ -197,6 +281,7 @@ public:
       }
       if (n.cur && !n.cur->empty())
         return &n.cur->front();
+      starve(n);
       return NULL;
     }
   }
@@ -235,6 +320,21 @@ public:
     push(rp.first, rp.second);
   }
 
+  /**
+   * Reports the chunks this thread published as statistics of a loop: the
+   * number of chunks and items in them (their ratio is the average chunk
+   * size) and how often the fill size was halved. Called by executors on
+   * each thread at the end of a loop.
+   *
+   * @param loopname Name of the loop to report under
+   */
+  void reportStats(const char* loopname) {
+    p& n = data.get();
+    runtime::reportStat_Tsum(loopname, "Chunks", n.chunksPushed);
+    runtime::reportStat_Tsum(loopname, "ChunkItems", n.itemsPushed);
+    runtime::reportStat_Tsum(loopname, "ChunkShrinks", n.shrinks);
+  }
+
   galois::optional<value_type> pop() {
     p& n = data.get();
     galois::optional<value_type> retval;
@@ -246,6 +346,7 @@ public:
       n.next = popChunk();
       if (n.next)
         return n.next->extract_back();
+      starve(n);
       return galois::optional<value_type>();
     } else {
       if (n.cur && (retval = n.cur->extract_front()))
@@ -259,6 +360,7 @@ public:
       }
       if (n.cur)
         return n.cur->extract_front();
+      starve(n);
       return galois::optional<value_type>();
     }
   }
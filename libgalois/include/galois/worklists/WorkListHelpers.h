@@ -73,6 +73,9 @@ public:
 
   bool empty() const { return !head.getValue(); }
 
+  //! True if another thread is in the middle of a pop
+  bool busy() const { return head.is_locked(); }
+
   void push(T* C) {
     T* oldhead(0);
     do {
@@ -124,6 +127,9 @@ public:
 
   bool empty() const { return !tail; }
 
+  //! True if another thread is in the middle of a push or pop
+  bool busy() const { return head.is_locked(); }
+
   void push(T* C) {
     head.lock();
     // std::cerr << "in(" << C << ") ";
@@ -0,0 +1,87 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+#include "galois/Galois.h"
+#include "galois/gIO.h"
+
+#include <atomic>
+#include <vector>
+
+// Checks that every item is processed exactly once while chunk sizes adapt,
+// including items pushed during the loop and chunks published before full.
+
+template <typename WL>
+void checkForEach(const char* name, unsigned numItems) {
+  std::vector<std::atomic<unsigned>> seen(2 * numItems);
+  for (auto& s : seen)
+    s = 0;
+  std::vector<unsigned> initial;
+  // few initial items so that threads start out starving
+  for (unsigned i = 0; i < numItems; i += 97)
+    initial.push_back(i);
+
+  galois::for_each(
+      galois::iterate(initial),
+      [&](unsigned i, auto& ctx) {
+        seen[i].fetch_add(1);
+        if (i >= numItems)
+          return;
+        // every item spawns its successor up to the next initial item and
+        // one item that spawns nothing
+        if ((i + 1) % 97 && i + 1 < numItems)
+          ctx.push(i + 1);
+        ctx.push(numItems + i);
+      },
+      galois::wl<WL>(), galois::loopname(name));
+
+  for (unsigned i = 0; i < 2 * numItems; ++i) {
+    GALOIS_ASSERT(seen[i] == 1, name, ": item ", i, " seen ", seen[i]);
+  }
+}
+
+void checkDoAll(unsigned numItems) {
+  std::vector<std::atomic<unsigned>> seen(numItems);
+  for (auto& s : seen)
+    s = 0;
+  galois::do_all(
+      galois::iterate(0u, numItems),
+      [&](unsigned i) {
+        // uneven work so that threads finish their ranges at different times
+        volatile unsigned spin = (i % 1024 == 0) ? 200000 : 0;
+        while (spin)
+          spin = spin - 1;
+        seen[i].fetch_add(1);
+      },
+      galois::steal(), galois::chunk_size<64>(),
+      galois::loopname("do_all-adaptive"));
+  for (unsigned i = 0; i < numItems; ++i) {
+    GALOIS_ASSERT(seen[i] == 1, "do_all: item ", i, " seen ", seen[i]);
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  const unsigned numItems = 1 << 16;
+  checkForEach<galois::worklists::PerSocketChunkFIFO<64>>("fifo", numItems);
+  checkForEach<galois::worklists::PerSocketChunkLIFO<64>>("lifo", numItems);
+  checkForEach<galois::worklists::ChunkFIFO<8>>("small-chunk", numItems);
+  checkDoAll(numItems);
+  return 0;
+}
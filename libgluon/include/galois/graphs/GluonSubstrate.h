@@ -28,12 +28,17 @@
 
 #include <unordered_map>
 #include <fstream>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <thread>
 
 #include "galois/runtime/GlobalObj.h"
 #include "galois/runtime/DistStats.h"
 #include "galois/runtime/SyncStructures.h"
 #include "galois/runtime/DataCommMode.h"
 #include "galois/DynamicBitset.h"
+#include "galois/DReducible.h"
 
 #ifdef GALOIS_ENABLE_GPU
 #include "galois/cuda/HostDecls.h"
@@ -458,6 +463,16 @@ public:
     Tgraph_construct_comm.stop();
   }
 
+  //! Waits for the last checkpoints (if any) to reach the disk; does not
+  //! report their write time as the stat manager may already be gone
+  ~GluonSubstrate() {
+    for (auto& checkpoint : checkpoints) {
+      if (checkpoint.second.writer.joinable()) {
+        checkpoint.second.writer.join();
+      }
+    }
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   // Data extraction from bitsets
   ////////////////////////////////////////////////////////////////////////////////
@@ -3437,7 +3452,10 @@ public:
    *
    * @param runNum Number to set the run to
    */
-  inline void set_num_run(const uint32_t runNum) { num_run = runNum; }
+  inline void set_num_run(const uint32_t runNum) {
+    num_run  = runNum;
+    runStart = std::chrono::steady_clock::now();
+  }
 
   /**
    * Get the set run number.
@@ -3542,89 +3560,322 @@ public:
 // Checkpointing code for graph
 ////////////////////////////////////////////////////////////////////////////////
 
-// @todo Checkpointing code needs updates to make it work.
-#ifdef GALOIS_CHECKPOINT
-///*
-// * Headers for boost serialization
-// */
-//#include <boost/archive/binary_oarchive.hpp>
-//#include <boost/archive/binary_iarchive.hpp>
-//#include <boost/serialization/split_member.hpp>
-//#include <boost/serialization/binary_object.hpp>
-//#include <boost/serialization/serialization.hpp>
-//#include <boost/serialization/vector.hpp>
-//#include <boost/serialization/unordered_map.hpp>
-//
-// public:
-//  /**
-//   * Checkpoint the complete structure on the node to disk
-//   */
-//  void checkpointSaveNodeData(std::string checkpointFileName = "checkpoint") {
-//    using namespace boost::archive;
-//    galois::StatTimer TimerSaveCheckPoint(
-//        get_run_identifier("TimerSaveCheckpoint").c_str(), RNAME);
-//
-//    TimerSaveCheckPoint.start();
-//    std::string checkpointFileName_local =
-//        checkpointFileName + "_" + std::to_string(id);
-//
-//    std::ofstream outputStream(checkpointFileName_local, std::ios::binary);
-//    if (!outputStream.is_open()) {
-//      galois::gPrint("ERROR: Could not open ", checkpointFileName_local,
-//                     " to save checkpoint!!!\n");
-//    }
-//    galois::gPrint("[", id,
-//                   "] Saving local checkpoint to :", checkpointFileName_local,
-//                   "\n");
-//
-//    boost::archive::binary_oarchive ar(outputStream,
-//    boost::archive::no_header);
-//
-//    // TODO handle this with CuSP
-//    userGraph.serializeNodeData(ar);
-//
-//    std::string statSendBytes_str("CheckpointBytesTotal");
-//    constexpr static const char* const RREGION = "RECOVERY";
-//    size_t cp_size                             = outputStream.tellp();
-//    galois::runtime::reportStat_Tsum(RREGION, statSendBytes_str, cp_size);
-//
-//    outputStream.flush();
-//    outputStream.close();
-//    TimerSaveCheckPoint.stop();
-//  }
-//
-//  /**
-//   * Load checkpointed data from disk.
-//   */
-//  void checkpointApplyNodeData(std::string checkpointFileName = "checkpoint")
-//  {
-//    using namespace boost::archive;
-//    galois::StatTimer TimerApplyCheckPoint(
-//        get_run_identifier("TimerApplyCheckpoint").c_str(), RNAME);
-//
-//    TimerApplyCheckPoint.start();
-//    std::string checkpointFileName_local =
-//        checkpointFileName + "_" + std::to_string(id);
-//
-//    std::ifstream inputStream(checkpointFileName_local, std::ios::binary);
-//
-//    if (!inputStream.is_open()) {
-//      galois::gPrint("ERROR: Could not open ", checkpointFileName_local,
-//                     " to read checkpoint!!!\n");
-//    }
-//    galois::gPrint("[", id, "] reading local checkpoint from: ",
-//                   checkpointFileName_local, "\n");
-//
-//    boost::archive::binary_iarchive ar(inputStream,
-//    boost::archive::no_header);
-//
-//    // TODO handle this with CuSP
-//    userGraph.deSerializeNodeData(ar);
-//
-//    inputStream.close();
-//    TimerApplyCheckPoint.stop();
-//  }
-#endif
+private:
+  //! Marks the beginning of a checkpoint file
+  static constexpr uint64_t checkpointMagic = 0x474c554f4e434b50;
+
+  //! Header at the beginning of a checkpoint file
+  struct CheckpointHeader {
+    uint64_t magic;     //!< checkpointMagic
+    uint32_t run;       //!< run the checkpoint was taken in
+    uint32_t round;     //!< round the checkpoint was taken at
+    uint64_t numNodes;  //!< number of proxies on the host
+    uint64_t numChunks; //!< number of chunks of values that follow
+  };
+
+  //! Header of a chunk of serialized values in a checkpoint file
+  struct CheckpointChunk {
+    uint64_t begin; //!< local id of the first node in the chunk
+    uint64_t end;   //!< local id after the last node in the chunk
+    uint64_t bytes; //!< size of the serialized values in the chunk
+  };
+
+  //! Checkpointing state of one checkpointed field
+  struct CheckpointState {
+    //! Background thread writing the last checkpoint of the field to disk
+    std::thread writer;
+    //! Which of the 2 files of the field the next checkpoint goes to
+    unsigned slot = 0;
+    //! Round of the checkpoint written by writer
+    uint32_t writeRound = 0;
+    //! Time (ms) writer took to write its checkpoint
+    uint64_t writeTime = 0;
+    //! Run of the last checkpoint of the field
+    uint32_t lastRun = 0;
+    //! End of the last checkpoint of the field; only valid if count > 0
+    std::chrono::steady_clock::time_point lastEnd;
+    //! Number of checkpoints of the field taken so far
+    uint64_t count = 0;
+  };
+
+  //! Checkpointing state of each field, keyed by checkpoint name
+  std::unordered_map<std::string, CheckpointState> checkpoints;
+  //! Start of the current run; the first checkpoint interval of a run is
+  //! measured from it
+  std::chrono::steady_clock::time_point runStart =
+      std::chrono::steady_clock::now();
+
+  /**
+   * Get the name of one of this host's checkpoint files.
+   *
+   * @param checkpointName Path prefix of the checkpoint files
+   * @param slot Which of the 2 files of this host to name
+   */
+  std::string checkpointFile(const std::string& checkpointName,
+                             unsigned slot) const {
+    return checkpointName + "_" + std::to_string(id) + "_" +
+           std::to_string(slot);
+  }
+
+  /**
+   * Wait for the checkpoint of a field being written in the background (if
+   * any) to reach the disk and report how long writing it took.
+   *
+   * @param state Checkpointing state of the field
+   */
+  void waitForCheckpointWrite(CheckpointState& state) {
+    if (state.writer.joinable()) {
+      state.writer.join();
+      galois::runtime::reportStat_Tmax(
+          RNAME, get_run_identifier("CheckpointWriteTime", state.writeRound),
+          state.writeTime);
+    }
+  }
+
+  /**
+   * Get the round a checkpoint file was taken at.
+   *
+   * @param fileName Checkpoint file to read the header of
+   * @returns Round of the checkpoint, or 0 if the file does not exist, was
+   * not written for this partition, or was written in a different run
+   */
+  uint32_t checkpointRound(const std::string& fileName) const {
+    std::ifstream in(fileName, std::ios::binary);
+    CheckpointHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != checkpointMagic ||
+        header.numNodes != userGraph.size() || header.run != num_run) {
+      return 0;
+    }
+    return header.round;
+  }
+
+  /**
+   * Get the rounds of the 2 checkpoint files of a field on this host after
+   * waiting for any write of the field in flight.
+   *
+   * @param checkpointName Path prefix of the checkpoint files
+   */
+  std::array<uint32_t, 2>
+  localCheckpointRounds(const std::string& checkpointName) {
+    waitForCheckpointWrite(checkpoints[checkpointName]);
+    return {checkpointRound(checkpointFile(checkpointName, 0)),
+            checkpointRound(checkpointFile(checkpointName, 1))};
+  }
+
+  /**
+   * Determine if every host has a checkpoint of a field at a round.
+   * Collective: all hosts must call it.
+   *
+   * @param rounds Rounds of the checkpoint files of the field on this host
+   * @param round Round to look for
+   */
+  bool checkpointOnAllHosts(const std::array<uint32_t, 2>& rounds,
+                            uint32_t round) {
+    galois::DGAccumulator<uint32_t> hostsWithRound;
+    hostsWithRound.reset();
+    hostsWithRound += (round && (rounds[0] == round || rounds[1] == round));
+    return hostsWithRound.reduce() == numHosts;
+  }
+
+public:
+  /**
+   * Checkpoint the field specified by a sync structure on all proxies of
+   * this host. Must be called by all hosts at the same round boundary.
+   *
+   * Values are extracted before the call returns, so the field may be
+   * modified right after it. Writing them to disk is done by a background
+   * thread and overlaps with computation until the next checkpoint of the
+   * same field. Each field alternates between 2 files per host and only
+   * ever has 1 write in flight, so its previous checkpoint is intact if the
+   * host fails during a write. Fields checkpointed at the same rounds can be
+   * restored to a common round with checkpointLatestRound.
+   *
+   * Besides the time taken, the time is reported as a percentage of the
+   * time since the previous checkpoint of the field (or the start of the
+   * run) to make the overhead of a checkpoint interval easy to check.
+   *
+   * @tparam FnTy sync structure that specifies the field to save
+   * @param checkpointName Path prefix of the checkpoint files of the field;
+   * the host id and file slot are appended to it
+   * @param round Number of rounds completed in the current run; must be
+   * non-zero and increase from one checkpoint of the field to the next
+   */
+  template <typename FnTy>
+  void checkpointSaveNodeData(const std::string& checkpointName,
+                              uint32_t round) {
+    assert(round > 0);
+    auto checkpointStart = std::chrono::steady_clock::now();
+    galois::StatTimer checkpointTimer(
+        get_run_identifier("CheckpointTime", round).c_str(), RNAME);
+    checkpointTimer.start();
+    CheckpointState& state = checkpoints[checkpointName];
+    waitForCheckpointWrite(state);
+
+    // each thread serializes the values of its block of nodes into a chunk
+    unsigned numChunks = galois::runtime::activeThreads;
+    std::vector<CheckpointChunk> chunks(numChunks);
+    std::vector<galois::runtime::SendBuffer> buffers(numChunks);
+    galois::on_each([&](unsigned tid, unsigned numThreads) {
+      auto r = galois::block_range(size_t{0}, userGraph.size(), tid,
+                                   numThreads);
+      for (size_t lid = r.first; lid < r.second; ++lid) {
+        galois::runtime::gSerialize(buffers[tid],
+                                    FnTy::extract(lid, userGraph.getData(lid)));
+      }
+      chunks[tid] = CheckpointChunk{r.first, r.second, buffers[tid].size()};
+    });
+
+    uint64_t checkpointBytes = sizeof(CheckpointHeader);
+    for (auto& chunk : chunks) {
+      checkpointBytes += sizeof(CheckpointChunk) + chunk.bytes;
+    }
+    galois::runtime::reportStat_Tsum(
+        RNAME, get_run_identifier("CheckpointBytes", round), checkpointBytes);
+
+    CheckpointHeader header{checkpointMagic, num_run, round,
+                            userGraph.size(), numChunks};
+    std::string fileName = checkpointFile(checkpointName, state.slot);
+    state.slot ^= 1;
+    state.writeRound = round;
+
+    state.writer = std::thread([&state, header, fileName,
+                                chunks = std::move(chunks),
+                                buffers = std::move(buffers)]() {
+      galois::Timer writeTimer;
+      writeTimer.start();
+      // write to a temporary file first so that a failure during the write
+      // never leaves a partial checkpoint under the real name
+      std::string tmpName = fileName + ".tmp";
+      std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (size_t i = 0; i < chunks.size(); ++i) {
+        out.write(reinterpret_cast<const char*>(&chunks[i]),
+                  sizeof(CheckpointChunk));
+        out.write(reinterpret_cast<const char*>(buffers[i].linearData()),
+                  buffers[i].size());
+      }
+      out.close();
+      if (!out || std::rename(tmpName.c_str(), fileName.c_str())) {
+        galois::gWarn("failed to write checkpoint ", fileName);
+      }
+      writeTimer.stop();
+      state.writeTime = writeTimer.get();
+    });
+
+    checkpointTimer.stop();
+
+    // overhead relative to the computation since the previous checkpoint
+    auto checkpointEnd = std::chrono::steady_clock::now();
+    auto intervalStart =
+        (state.count && state.lastRun == num_run) ? state.lastEnd : runStart;
+    double checkpointTime =
+        std::chrono::duration<double>(checkpointEnd - checkpointStart).count();
+    double computeTime =
+        std::chrono::duration<double>(checkpointStart - intervalStart).count();
+    if (computeTime > 0) {
+      galois::runtime::reportStat_Tmax(
+          RNAME, get_run_identifier("CheckpointOverheadPercent", round),
+          100 * checkpointTime / computeTime);
+    }
+    state.lastRun = num_run;
+    state.lastEnd = checkpointEnd;
+    state.count++;
+  }
+
+  /**
+   * Get the latest round of the current run at which every host has a
+   * complete checkpoint of a field. Must be called by all hosts.
+   *
+   * All hosts checkpoint at the same rounds and keep the previous
+   * checkpoint until the next one is complete, so the earliest latest round
+   * among hosts is complete everywhere unless a host has none. To restore
+   * several fields to the same round, pass the minimum of their latest
+   * rounds to checkpointApplyNodeData.
+   *
+   * @param checkpointName Path prefix the checkpoints were saved with
+   * @returns Latest round checkpointed by every host, or 0 if there is none
+   */
+  uint32_t checkpointLatestRound(const std::string& checkpointName) {
+    std::array<uint32_t, 2> rounds = localCheckpointRounds(checkpointName);
+    galois::DGReduceMin<uint32_t> latestRound;
+    latestRound.update(std::max(rounds[0], rounds[1]));
+    uint32_t round = latestRound.reduce();
+    return checkpointOnAllHosts(rounds, round) ? round : 0;
+  }
+
+  /**
+   * Restore the field specified by a sync structure on all proxies of this
+   * host from a checkpoint taken in the current run. Must be called by all
+   * hosts.
+   *
+   * @tparam FnTy sync structure that specifies the field to restore
+   * @param checkpointName Path prefix the checkpoints were saved with
+   * @param round Round to restore; 0 restores the latest round every host
+   * completed (see checkpointLatestRound)
+   * @returns Round of the restored checkpoint, or 0 if every host does not
+   * have a checkpoint at the round (the field is then left untouched)
+   */
+  template <typename FnTy>
+  uint32_t checkpointApplyNodeData(const std::string& checkpointName,
+                                   uint32_t round = 0) {
+    galois::StatTimer restoreTimer(
+        get_run_identifier("CheckpointRestoreTime").c_str(), RNAME);
+    restoreTimer.start();
+
+    std::array<uint32_t, 2> rounds = localCheckpointRounds(checkpointName);
+    if (!round) {
+      round = checkpointLatestRound(checkpointName);
+    } else if (!checkpointOnAllHosts(rounds, round)) {
+      round = 0;
+    }
+    if (!round) {
+      if (id == 0) {
+        galois::gWarn("no checkpoint ", checkpointName,
+                      " of this run was completed by every host; starting "
+                      "over");
+      }
+      restoreTimer.stop();
+      return 0;
+    }
+
+    unsigned slot        = (rounds[0] == round) ? 0 : 1;
+    std::string fileName = checkpointFile(checkpointName, slot);
+    std::ifstream in(fileName, std::ios::binary);
+    CheckpointHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::vector<CheckpointChunk> chunks(header.numChunks);
+    std::vector<galois::runtime::RecvBuffer> buffers(header.numChunks);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      in.read(reinterpret_cast<char*>(&chunks[i]), sizeof(CheckpointChunk));
+      galois::PODResizeableArray<uint8_t> data;
+      data.resize(chunks[i].bytes);
+      in.read(reinterpret_cast<char*>(data.data()), chunks[i].bytes);
+      buffers[i] = galois::runtime::RecvBuffer(std::move(data));
+    }
+    if (!in) {
+      GALOIS_DIE("checkpoint ", fileName, " is truncated");
+    }
+
+    galois::do_all(
+        galois::iterate(size_t{0}, chunks.size()),
+        [&](size_t i) {
+          for (size_t lid = chunks[i].begin; lid < chunks[i].end; ++lid) {
+            typename FnTy::ValTy val;
+            galois::runtime::gDeserialize(buffers[i], val);
+            FnTy::setVal(lid, userGraph.getData(lid), val);
+          }
+        },
+        galois::no_stats());
+
+    // the next checkpoint must not overwrite the one just restored
+    checkpoints[checkpointName].slot = slot ^ 1;
+    restoreTimer.stop();
+    if (id == 0) {
+      galois::gPrint("Restored ", checkpointName, " from round ", round, "\n");
+    }
+    return round;
+  }
 };
 
 template <typename GraphTy>
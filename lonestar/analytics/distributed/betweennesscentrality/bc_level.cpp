@@ -547,9 +547,14 @@ struct Sanity {
                      galois::no_stats(), galois::loopname("Sanity"));
     }
 
-    float max_bc = DGA_max.reduce();
-    float min_bc = DGA_min.reduce();
-    float bc_sum = DGA_sum.reduce();
+    // reduce all statistics with one collective
+    galois::DGReduceBatch stats;
+    stats.add(DGA_max).add(DGA_min).add(DGA_sum);
+    stats.reduce();
+
+    float max_bc = DGA_max.read();
+    float min_bc = DGA_min.read();
+    float bc_sum = DGA_sum.read();
 
     // Only node 0 will print data
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
@@ -507,9 +507,14 @@ void Sanity(Graph& graph) {
       },
       galois::no_stats(), galois::loopname("Sanity"));
 
-  float max_bc = DGA_max.reduce();
-  float min_bc = DGA_min.reduce();
-  float bc_sum = DGA_sum.reduce();
+  // reduce all statistics with one collective
+  galois::DGReduceBatch stats;
+  stats.add(DGA_max).add(DGA_min).add(DGA_sum);
+  stats.reduce();
+
+  float max_bc = DGA_max.read();
+  float min_bc = DGA_min.read();
+  float bc_sum = DGA_sum.read();
 
   // Only node 0 will print data
   if (galois::runtime::getSystemNetworkInterface().ID == 0) {
@@ -635,6 +640,18 @@ int main(int argc, char** argv) {
     uint64_t nodeBoundary =
         sourceVector.empty() ? hg->globalSize() : sourceVector.size();
 
+    // resume the batches of the first run from the last checkpoint of this
+    // process's first run; every checkpointed batch used the full number of
+    // sources
+    if (restartFromCheckpoint && run == 0 && !useSingleSource) {
+      uint32_t batchesDone =
+          syncSubstrate->checkpointApplyNodeData<Reduce_set_bc>(
+              checkpointPath("bc"));
+      macroRound        = batchesDone;
+      offset           += batchesDone * numSourcesPerRound;
+      totalSourcesFound = batchesDone * numSourcesPerRound;
+    }
+
     while (offset < nodeBoundary && totalSourcesFound < totalNumSources) {
       if (useSingleSource) {
         nodesToConsider[0] = startNode;
@@ -710,6 +727,16 @@ int main(int argc, char** argv) {
       }
 
       macroRound++;
+
+      // only full batches are checkpointed so that a restart can derive the
+      // sources done from the number of batches; the last batch may be
+      // partial and there is nothing left to save work on after it anyway
+      bool lastBatch =
+          offset >= nodeBoundary || totalSourcesFound >= totalNumSources;
+      if (!lastBatch && checkpointDue(macroRound)) {
+        syncSubstrate->checkpointSaveNodeData<Reduce_set_bc>(
+            checkpointPath("bc"), macroRound);
+      }
     }
 
     Sanity(*hg);
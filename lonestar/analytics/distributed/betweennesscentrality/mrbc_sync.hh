@@ -199,3 +199,9 @@ struct DependencyReduce {
 
 GALOIS_SYNC_STRUCTURE_BITSET(minDistances);
 GALOIS_SYNC_STRUCTURE_BITSET(dependency);
+
+////////////////////////////////////////////////////////////////////////////////
+// Checkpointing
+////////////////////////////////////////////////////////////////////////////////
+
+GALOIS_SYNC_STRUCTURE_REDUCE_SET(bc, float);
@@ -233,8 +233,13 @@ struct BFSSanityCheck {
                      galois::no_stats(), galois::loopname("BFSSanityCheck"));
     }
 
-    uint64_t num_visited  = dgas.reduce();
-    uint32_t max_distance = dgm.reduce();
+    // reduce all statistics with one collective
+    galois::DGReduceBatch stats;
+    stats.add(dgas).add(dgm);
+    stats.reduce();
+
+    uint64_t num_visited  = dgas.read();
+    uint32_t max_distance = dgm.read();
 
     // Only host 0 will print the info
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
@@ -217,6 +217,14 @@ struct SGD {
     galois::gPrint("Nodes with edges on : ", net.ID, " : ",
                    std::distance(nodesWithEdges.begin(), nodesWithEdges.end()),
                    "\n");
+
+    // resume the first run from the last checkpoint
+    if (restartFromCheckpoint && syncSubstrate->get_run_num() == 0) {
+      _num_iterations =
+          syncSubstrate->checkpointApplyNodeData<Reduce_set_latent_vector>(
+              checkpointPath("latent_vector"));
+    }
+
     do {
       galois::gPrint("ITERATION : ", _num_iterations, "\n");
 
@@ -241,6 +249,13 @@ struct SGD {
       rms_normalized = std::sqrt(dga.reduce() / _graph.globalSizeEdges());
       galois::gDebug("RMS Normalized : ", rms_normalized);
       galois::gPrint("RMS Normalized: ", rms_normalized, "\n");
+
+      // no need to checkpoint if this was the last iteration
+      if (checkpointDue(_num_iterations) &&
+          (_num_iterations < maxIterations) && (rms_normalized > 1)) {
+        syncSubstrate->checkpointSaveNodeData<Reduce_set_latent_vector>(
+            checkpointPath("latent_vector"), _num_iterations);
+      }
     } while ((_num_iterations < maxIterations) && (rms_normalized > 1));
 
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
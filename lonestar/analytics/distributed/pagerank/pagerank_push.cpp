@@ -389,13 +389,19 @@ struct PageRankSanity {
                      galois::no_stats(), galois::loopname("PageRankSanity"));
     }
 
-    float max_rank          = max_value.reduce();
-    float min_rank          = min_value.reduce();
-    float rank_sum          = DGA_sum.reduce();
-    float residual_sum      = DGA_sum_residual.reduce();
-    uint64_t over_tolerance = DGA_residual_over_tolerance.reduce();
-    float max_res           = max_residual.reduce();
-    float min_res           = min_residual.reduce();
+    // reduce all statistics with one collective
+    galois::DGReduceBatch stats;
+    stats.add(max_value).add(min_value).add(DGA_sum).add(DGA_sum_residual)
+        .add(DGA_residual_over_tolerance).add(max_residual).add(min_residual);
+    stats.reduce();
+
+    float max_rank          = max_value.read();
+    float min_rank          = min_value.read();
+    float rank_sum          = DGA_sum.read();
+    float residual_sum      = DGA_sum_residual.read();
+    uint64_t over_tolerance = DGA_residual_over_tolerance.read();
+    float max_res           = max_residual.read();
+    float min_res           = min_residual.read();
 
     // Only node 0 will print data
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
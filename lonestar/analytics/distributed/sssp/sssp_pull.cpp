@@ -239,10 +239,15 @@ struct SSSPSanityCheck {
                      galois::no_stats(), galois::loopname("SSSPSanityCheck"));
     }
 
-    uint64_t num_visited  = dgas.reduce();
-    uint32_t max_distance = dgm.reduce();
+    // reduce all statistics with one collective
+    galois::DGReduceBatch stats;
+    stats.add(dgas).add(dgm).add(dgag);
+    stats.reduce();
 
-    float visit_average = ((float)dgag.reduce()) / num_visited;
+    uint64_t num_visited  = dgas.read();
+    uint32_t max_distance = dgm.read();
+
+    float visit_average = ((float)dgag.read()) / num_visited;
 
     // Only host 0 will print the info
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
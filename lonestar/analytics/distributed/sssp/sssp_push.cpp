@@ -23,6 +23,8 @@
 #include "galois/DReducible.h"
 #include "galois/DTerminationDetector.h"
 #include "galois/gstl.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
 #include "galois/runtime/Tracer.h"
 
 #include <iostream>
@@ -53,11 +55,18 @@ static cll::opt<uint64_t>
 
 static cll::opt<uint32_t>
     delta("delta",
-          cll::desc("Shift value for the delta step (default value 0)"),
+          cll::desc("Shift value for the delta step (default value 0); "
+                    "bucket width with -deltaStepping"),
           cll::init(0));
 
 enum Exec { Sync, Async };
 
+static cll::opt<bool> deltaStepping(
+    "deltaStepping",
+    cll::desc("Use distributed delta-stepping with buckets of width -delta "
+              "(default false; CPU and bulk-synchronous only)"),
+    cll::init(false));
+
 static cll::opt<Exec> execution(
     "exec", cll::desc("Distributed Execution Model (default value Async):"),
     cll::values(clEnumVal(Sync, "Bulk-synchronous Parallel (BSP)"),
@@ -76,6 +85,9 @@ struct NodeData {
 };
 
 galois::DynamicBitSet bitset_dist_current;
+//! index of the first heavy (weight > delta) edge of every node when
+//! delta-stepping; edges of a node are sorted by weight
+galois::LargeArray<uint64_t> heavyEdgeBegin;
 
 typedef galois::graphs::DistGraph<NodeData, unsigned int> Graph;
 typedef typename Graph::GraphNode GNode;
@@ -286,6 +298,183 @@ struct SSSP {
   }
 };
 
+/**
+ * Distributed delta-stepping. Nodes are put in buckets of width delta by
+ * distance, and all hosts agree on the bucket to work on with a global
+ * min-reduction over the buckets of their active nodes, which also detects
+ * termination. In each round, a host relaxes the light edges (weight <=
+ * delta) of its active nodes in the bucket until none of its nodes in the
+ * bucket is active, and then syncs. Once no host has an active node in the
+ * bucket, the distances in it are final and the heavy edges of its nodes are
+ * relaxed once; they can only update nodes in later buckets.
+ */
+struct DeltaStepSSSP {
+  using DGAccumulatorTy = galois::DGAccumulator<unsigned int>;
+
+  static uint32_t bucketOf(uint32_t dist) { return dist / delta; }
+
+  /**
+   * Sorts the edges of every node by weight and records where its heavy
+   * edges begin. Must be called once after the graph is loaded.
+   */
+  static void splitEdges(Graph& _graph) {
+    _graph.sortEdgesByEdgeData();
+    heavyEdgeBegin.allocateBlocked(_graph.size());
+    galois::do_all(
+        galois::iterate(_graph.allNodesRange()),
+        [&](GNode n) {
+          heavyEdgeBegin[n] = *std::partition_point(
+              _graph.edge_begin(n), _graph.edge_end(n),
+              [&](auto e) { return _graph.getEdgeData(e) <= delta; });
+        },
+        galois::no_stats(), galois::loopname("SplitLightHeavyEdges"));
+  }
+
+  //! Relaxes the light edges of the active nodes of a bucket on this host
+  //! until none of its nodes in the bucket is active
+  static void relaxLight(Graph& _graph, uint32_t bucket,
+                         DGAccumulatorTy& work_edges) {
+    galois::InsertBag<GNode> active;
+    galois::do_all(
+        galois::iterate(_graph.allNodesWithEdgesRange()),
+        [&](GNode n) {
+          NodeData& ndata = _graph.getData(n);
+          if (ndata.dist_old > ndata.dist_current &&
+              bucketOf(ndata.dist_current) == bucket) {
+            active.push(n);
+          }
+        },
+        galois::no_stats(), galois::loopname("BucketNodes"));
+
+    galois::for_each(
+        galois::iterate(active),
+        [&](GNode src, auto& ctx) {
+          NodeData& snode = _graph.getData(src);
+          uint32_t dist   = snode.dist_current;
+          if (snode.dist_old <= dist) {
+            return; // already relaxed with this distance
+          }
+          snode.dist_old = dist;
+
+          Graph::edge_iterator heavy(heavyEdgeBegin[src]);
+          for (auto jj = _graph.edge_begin(src); jj != heavy; ++jj) {
+            work_edges += 1;
+
+            GNode dst         = _graph.getEdgeDst(jj);
+            auto& dnode       = _graph.getData(dst);
+            uint32_t new_dist = _graph.getEdgeData(jj) + dist;
+            uint32_t old_dist = galois::atomicMin(dnode.dist_current, new_dist);
+            if (old_dist > new_dist) {
+              bitset_dist_current.set(dst);
+              if (bucketOf(new_dist) == bucket) {
+                ctx.push(dst);
+              }
+            }
+          }
+        },
+        galois::wl<galois::worklists::PerSocketChunkFIFO<64>>(),
+        galois::disable_conflict_detection(), galois::no_stats(),
+        galois::loopname(syncSubstrate->get_run_identifier("SSSP").c_str()));
+  }
+
+  //! Relaxes the heavy edges of the nodes of a bucket on this host
+  static void relaxHeavy(Graph& _graph, uint32_t bucket,
+                         DGAccumulatorTy& work_edges) {
+    galois::do_all(
+        galois::iterate(_graph.allNodesWithEdgesRange()),
+        [&](GNode src) {
+          NodeData& snode = _graph.getData(src);
+          uint32_t dist   = snode.dist_current;
+          if (dist >= infinity || bucketOf(dist) != bucket) {
+            return;
+          }
+
+          Graph::edge_iterator heavy(heavyEdgeBegin[src]);
+          for (auto jj = heavy, ej = _graph.edge_end(src); jj != ej; ++jj) {
+            work_edges += 1;
+
+            GNode dst         = _graph.getEdgeDst(jj);
+            auto& dnode       = _graph.getData(dst);
+            uint32_t new_dist = _graph.getEdgeData(jj) + dist;
+            uint32_t old_dist = galois::atomicMin(dnode.dist_current, new_dist);
+            if (old_dist > new_dist)
+              bitset_dist_current.set(dst);
+          }
+        },
+        galois::no_stats(), galois::steal(),
+        galois::loopname(
+            syncSubstrate->get_run_identifier("SSSPHeavy").c_str()));
+  }
+
+  //! Gets the lowest bucket with an active node on any host (max uint32_t
+  //! if there is none)
+  static uint32_t nextBucket(Graph& _graph,
+                             galois::DGReduceMin<uint32_t>& minBucket) {
+    minBucket.reset();
+    galois::do_all(
+        galois::iterate(_graph.allNodesWithEdgesRange()),
+        [&](GNode n) {
+          NodeData& ndata = _graph.getData(n);
+          if (ndata.dist_old > ndata.dist_current) {
+            minBucket.update(bucketOf(ndata.dist_current));
+          }
+        },
+        galois::no_stats(), galois::loopname("MinBucket"));
+    return minBucket.reduce(syncSubstrate->get_run_identifier());
+  }
+
+  //! Runs one round: local work followed by a sync
+  template <typename WorkTy>
+  static void round(unsigned _num_iterations, DGAccumulatorTy& work_edges,
+                    WorkTy work) {
+    syncSubstrate->set_num_round(_num_iterations);
+    work_edges.reset();
+    work();
+    syncSubstrate->sync<writeDestination, readSource, Reduce_min_dist_current,
+                        Bitset_dist_current, false>("SSSP");
+    galois::runtime::reportStat_Tsum(
+        "SSSP", "NumWorkItems_" + (syncSubstrate->get_run_identifier()),
+        work_edges.read_local());
+  }
+
+  void static go(Graph& _graph) {
+    // make the source active so that the first bucket starts from it
+    if (_graph.isLocal(src_node)) {
+      _graph.getData(_graph.getLID(src_node)).dist_old = infinity;
+    }
+
+    unsigned _num_iterations = 0;
+    unsigned numBuckets      = 0;
+    DGAccumulatorTy work_edges;
+    galois::DGReduceMin<uint32_t> minBucket;
+
+    uint32_t bucket = nextBucket(_graph, minBucket);
+    while (bucket != std::numeric_limits<uint32_t>::max() &&
+           _num_iterations < maxIterations) {
+      round(_num_iterations++, work_edges,
+            [&]() { relaxLight(_graph, bucket, work_edges); });
+
+      uint32_t next = nextBucket(_graph, minBucket);
+      if (next != bucket) {
+        // no host has active nodes left in the bucket; distances in it are
+        // final
+        round(_num_iterations++, work_edges,
+              [&]() { relaxHeavy(_graph, bucket, work_edges); });
+        ++numBuckets;
+        next = nextBucket(_graph, minBucket);
+      }
+      bucket = next;
+    }
+
+    galois::runtime::reportStat_Tmax(
+        "SSSP", "NumIterations_" + std::to_string(syncSubstrate->get_run_num()),
+        _num_iterations);
+    galois::runtime::reportStat_Tmax(
+        "SSSP", "NumBuckets_" + std::to_string(syncSubstrate->get_run_num()),
+        numBuckets);
+  }
+};
+
 /******************************************************************************/
 /* Sanity check operators */
 /******************************************************************************/
@@ -332,10 +521,15 @@ struct SSSPSanityCheck {
                      galois::no_stats(), galois::loopname("SSSPSanityCheck"));
     }
 
-    uint64_t num_visited  = dgas.reduce();
-    uint32_t max_distance = dgm.reduce();
+    // reduce all statistics with one collective
+    galois::DGReduceBatch stats;
+    stats.add(dgas).add(dgm).add(dgag);
+    stats.reduce();
+
+    uint64_t num_visited  = dgas.read();
+    uint32_t max_distance = dgm.read();
 
-    float visit_average = ((float)dgag.reduce()) / num_visited;
+    float visit_average = ((float)dgag.read()) / num_visited;
 
     // Only host 0 will print the info
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
@@ -438,6 +632,16 @@ int main(int argc, char** argv) {
 
   bitset_dist_current.resize(hg->size());
 
+  if (deltaStepping) {
+    if (delta == 0) {
+      GALOIS_DIE("-deltaStepping requires a bucket width (-delta) > 0");
+    }
+    if (personality != CPU) {
+      GALOIS_DIE("-deltaStepping is only supported on CPUs");
+    }
+    DeltaStepSSSP::splitEdges(*hg);
+  }
+
   galois::gPrint("[", net.ID, "] InitializeGraph::go called\n");
 
   InitializeGraph::go((*hg));
@@ -454,7 +658,9 @@ int main(int argc, char** argv) {
     galois::StatTimer StatTimer_main(timer_str.c_str(), REGION_NAME);
 
     StatTimer_main.start();
-    if (execution == Async) {
+    if (deltaStepping) {
+      DeltaStepSSSP::go(*hg);
+    } else if (execution == Async) {
       SSSP<true>::go(*hg);
     } else {
       SSSP<false>::go(*hg);
@@ -27,6 +27,7 @@
 #define GALOIS_DISTBENCH_INPUT_H
 
 #include "galois/graphs/CuSPPartitioner.h"
+#include "galois/DReducible.h"
 #include "llvm/Support/CommandLine.h"
 
 /*******************************************************************************
@@ -46,7 +47,8 @@ enum PARTITIONING_SCHEME {
   GINGER_I, //!< Ginger, incoming
   FENNEL_O, //!< Fennel, oec
   FENNEL_I, //!< Fennel, iec
-  SUGAR_O   //!< Sugar, oec
+  SUGAR_O,  //!< Sugar, oec
+  AUTO      //!< picked from sampled graph statistics
 };
 
 /**
@@ -81,6 +83,8 @@ inline const char* EnumToString(PARTITIONING_SCHEME e) {
     return "fennel-iec";
   case SUGAR_O:
     return "sugar-oec";
+  case AUTO:
+    return "auto";
   default:
     GALOIS_DIE("unsupported partition scheme: ", e);
   }
@@ -109,9 +113,72 @@ extern cll::opt<std::string> localGraphFileName;
 extern cll::opt<bool> saveLocalGraph;
 //! file specifying blocking of masters
 extern cll::opt<std::string> mastersFile;
+//! per-host memory budget (MB) for streaming edges during partitioning
+extern cll::opt<uint64_t> partitionMemoryBudget;
 
 // @todo command line argument for read balancing across hosts
 
+/*******************************************************************************
+ * Automatic selection of the partitioning scheme
+ ******************************************************************************/
+
+//! replication factor predicted for the scheme picked by -partition=auto; 0
+//! if the scheme was given explicitly
+extern double predictedReplicationFactor;
+
+/**
+ * If -partition=auto was given, replaces partitionScheme with the scheme
+ * predicted to need the least communication; otherwise does nothing.
+ *
+ * The prediction counts the proxies that each of oec, iec, hovc, hivc, cvc
+ * and cvc-iec (the schemes that do not need an edge-by-edge streaming pass
+ * and whose inputs are available) would create for a fixed sample of evenly
+ * spaced nodes. Every host reads the edges of its own block of masters (of
+ * the input graph and, if given, its transpose), marks the hosts that would
+ * own each edge touching a sampled node, and the marks are or-ed across
+ * hosts in one collective, so the predicted replication factor is exact for
+ * the sample and all hosts pick the same scheme. The communication volume of
+ * a sync is modeled as the number of mirrors times the number of phases the
+ * scheme needs: 1 (reduce or broadcast) for edge cuts and 2 for vertex cuts.
+ * Must be called by all hosts.
+ *
+ * @param iterateOut true if the application iterates over out-edges (push
+ * style: writes destinations and reads sources), false if over in-edges
+ * (pull style); on ties, the edge cut in the same direction is preferred
+ * since it balances the edges the application iterates over
+ * @param symmetricGraph true if the input graph is symmetric
+ */
+void resolveAutoPartitionScheme(bool iterateOut, bool symmetricGraph);
+
+/**
+ * Logs the actual replication factor of a partitioned graph next to the one
+ * predicted by -partition=auto. Does nothing if the scheme was not picked
+ * automatically. Must be called by all hosts.
+ *
+ * @param graph Partitioned graph
+ */
+template <typename GraphTy>
+void reportReplicationFactor(GraphTy& graph) {
+  if (predictedReplicationFactor == 0) {
+    return;
+  }
+  galois::DGAccumulator<uint64_t> numProxies;
+  numProxies.reset();
+  numProxies += graph.size();
+  double actual = static_cast<double>(numProxies.reduce()) /
+                  std::max<uint64_t>(graph.globalSize(), 1);
+  if (galois::runtime::getSystemNetworkInterface().ID == 0) {
+    galois::runtime::reportStat_Single("DistBench",
+                                       "PredictedReplicationFactor",
+                                       predictedReplicationFactor);
+    galois::runtime::reportStat_Single("DistBench", "ActualReplicationFactor",
+                                       actual);
+    galois::gPrint("Replication factor of ", EnumToString(partitionScheme),
+                   ": predicted ", predictedReplicationFactor, ", actual ",
+                   actual, "\n");
+  }
+}
+
 /*******************************************************************************
  * Graph-loading functions
  ******************************************************************************/
@@ -120,6 +187,31 @@ template <typename NodeData, typename EdgeData>
 using DistGraphPtr =
     std::unique_ptr<galois::graphs::DistGraph<NodeData, EdgeData>>;
 
+/**
+ * Partitions the input graph given on the command line with CuSP, or reads
+ * the partition saved by an earlier run if -readFromFile is set.
+ *
+ * @tparam PartitionPolicy CuSP policy to partition with
+ * @tparam NodeData node data to store in graph
+ * @tparam EdgeData edge data to store in graph
+ * @param inputType format (CSR or CSC) of the input graph to read
+ * @param outputType format (CSR or CSC) of the partitions to create
+ * @param symmetricGraph true if the input graph is symmetric
+ * @param masterBlockFile file specifying blocking of masters, if any
+ * @returns a pointer to a newly allocated DistGraph
+ */
+template <typename PartitionPolicy, typename NodeData, typename EdgeData>
+DistGraphPtr<NodeData, EdgeData>
+cuspPartitionInput(galois::CUSP_GRAPH_TYPE inputType,
+                   galois::CUSP_GRAPH_TYPE outputType, bool symmetricGraph,
+                   const std::string& masterBlockFile = "") {
+  return galois::cuspPartitionGraph<PartitionPolicy, NodeData, EdgeData>(
+      inputFile, inputType, outputType, symmetricGraph, inputFileTranspose,
+      masterBlockFile, true, 100, galois::graphs::BALANCED_EDGES_OF_MASTERS,
+      0, 0, partitionMemoryBudget * 1024 * 1024,
+      readFromFile ? std::string(localGraphFileName) : std::string());
+}
+
 /**
  * Loads a symmetric graph file (i.e. directed graph with edges in both
  * directions)
@@ -138,24 +230,22 @@ constructSymmetricGraph(std::vector<unsigned>& GALOIS_UNUSED(scaleFactor)) {
                " please use the -symmetricGraph flag "
                " to indicate the input is a symmetric graph");
   }
+  resolveAutoPartitionScheme(true, true);
 
   switch (partitionScheme) {
   case OEC:
   case IEC:
-    return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose,
-        mastersFile);
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, true, mastersFile);
   case HOVC:
   case HIVC:
-    return galois::cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true,
-        inputFileTranspose);
+    return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, true);
 
   case CART_VCUT:
   case CART_VCUT_IEC:
-    return galois::cuspPartitionGraph<GenericCVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true,
-        inputFileTranspose);
+    return cuspPartitionInput<GenericCVC, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, true);
 
     // case CEC:
     //  return new Graph_customEdgeCut(inputFile, "", net.ID, net.Num,
@@ -163,20 +253,17 @@ constructSymmetricGraph(std::vector<unsigned>& GALOIS_UNUSED(scaleFactor)) {
 
   case GINGER_O:
   case GINGER_I:
-    return galois::cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true,
-        inputFileTranspose);
+    return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, true);
 
   case FENNEL_O:
   case FENNEL_I:
-    return galois::cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true,
-        inputFileTranspose);
+    return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, true);
 
   case SUGAR_O:
-    return galois::cuspPartitionGraph<SugarP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true,
-        inputFileTranspose);
+    return cuspPartitionInput<SugarP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, true);
   default:
     GALOIS_DIE("partition scheme specified is invalid: ", partitionScheme);
     return DistGraphPtr<NodeData, EdgeData>(nullptr);
@@ -202,51 +289,45 @@ DistGraphPtr<NodeData, EdgeData>
 constructGraph(std::vector<unsigned>& GALOIS_UNUSED(scaleFactor)) {
   // 1 host = no concept of cut; just load from edgeCut, no transpose
   auto& net = galois::runtime::getSystemNetworkInterface();
+  resolveAutoPartitionScheme(true, false);
   if (net.Num == 1) {
-    return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose);
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false);
   }
 
   switch (partitionScheme) {
   case OEC:
-    return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose, mastersFile);
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false, mastersFile);
   case IEC:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false,
-          inputFileTranspose, mastersFile);
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSR, false, mastersFile);
     } else {
       GALOIS_DIE("incoming edge cut requires transpose graph");
       break;
     }
 
   case HOVC:
-    return galois::cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose);
+    return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false);
   case HIVC:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false,
-          inputFileTranspose);
+      return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSR, false);
     } else {
       GALOIS_DIE("incoming hybrid cut requires transpose graph");
       break;
     }
 
   case CART_VCUT:
-    return galois::cuspPartitionGraph<GenericCVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose);
+    return cuspPartitionInput<GenericCVC, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false);
 
   case CART_VCUT_IEC:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<GenericCVC, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false,
-          inputFileTranspose);
+      return cuspPartitionInput<GenericCVC, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSR, false);
     } else {
       GALOIS_DIE("cvc incoming cut requires transpose graph");
       break;
@@ -257,37 +338,32 @@ constructGraph(std::vector<unsigned>& GALOIS_UNUSED(scaleFactor)) {
     //                                 scaleFactor, vertexIDMapFileName, false);
 
   case GINGER_O:
-    return galois::cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose);
+    return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false);
   case GINGER_I:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false,
-          inputFileTranspose);
+      return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSR, false);
     } else {
       GALOIS_DIE("Ginger requires transpose graph");
       break;
     }
 
   case FENNEL_O:
-    return galois::cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose);
+    return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false);
   case FENNEL_I:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false,
-          inputFileTranspose);
+      return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSR, false);
     } else {
       GALOIS_DIE("Fennel requires transpose graph");
       break;
     }
 
   case SUGAR_O:
-    return galois::cuspPartitionGraph<SugarP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false,
-        inputFileTranspose);
+    return cuspPartitionInput<SugarP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSR, false);
 
   default:
     GALOIS_DIE("partition scheme specified is invalid: ", partitionScheme);
@@ -313,100 +389,87 @@ template <typename NodeData, typename EdgeData, bool iterateOut = true,
           typename std::enable_if<!iterateOut>::type* = nullptr>
 DistGraphPtr<NodeData, EdgeData> constructGraph(std::vector<unsigned>&) {
   auto& net = galois::runtime::getSystemNetworkInterface();
+  resolveAutoPartitionScheme(false, false);
 
   // 1 host = no concept of cut; just load from edgeCut
   if (net.Num == 1) {
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false,
-          inputFileTranspose);
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSC, false);
     } else {
       fprintf(stderr, "WARNING: Loading transpose graph through in-memory "
                       "transpose to iterate over in-edges: pass in transpose "
                       "graph with -graphTranspose to avoid unnecessary "
                       "overhead.\n");
-      return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-          inputFileTranspose);
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+          galois::CUSP_CSR, galois::CUSP_CSC, false);
     }
   }
 
   switch (partitionScheme) {
   case OEC:
-    return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-        inputFileTranspose, mastersFile);
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false, mastersFile);
   case IEC:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false,
-          inputFileTranspose, mastersFile);
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSC, false, mastersFile);
     } else {
       GALOIS_DIE("iec requires transpose graph");
       break;
     }
 
   case HOVC:
-    return galois::cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-        inputFileTranspose);
+    return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false);
   case HIVC:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false,
-          inputFileTranspose);
+      return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSC, false);
     } else {
       GALOIS_DIE("hivc requires transpose graph");
       break;
     }
 
   case CART_VCUT:
-    return galois::cuspPartitionGraph<GenericCVCColumnFlip, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-        inputFileTranspose);
+    return cuspPartitionInput<GenericCVCColumnFlip, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false);
   case CART_VCUT_IEC:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<GenericCVCColumnFlip, NodeData,
-                                        EdgeData>(inputFile, galois::CUSP_CSC,
-                                                  galois::CUSP_CSC, false,
-                                                  inputFileTranspose);
+      return cuspPartitionInput<GenericCVCColumnFlip, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSC, false);
     } else {
       GALOIS_DIE("cvc requires transpose graph");
       break;
     }
 
   case GINGER_O:
-    return galois::cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-        inputFileTranspose);
+    return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false);
   case GINGER_I:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false,
-          inputFileTranspose);
+      return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSC, false);
     } else {
       GALOIS_DIE("Ginger requires transpose graph");
       break;
     }
 
   case FENNEL_O:
-    return galois::cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-        inputFileTranspose);
+    return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false);
   case FENNEL_I:
     if (inputFileTranspose.size()) {
-      return galois::cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-          inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false,
-          inputFileTranspose);
+      return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+          galois::CUSP_CSC, galois::CUSP_CSC, false);
     } else {
       GALOIS_DIE("Fennel requires transpose graph");
       break;
     }
 
   case SUGAR_O:
-    return galois::cuspPartitionGraph<SugarColumnFlipP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false,
-        inputFileTranspose);
+    return cuspPartitionInput<SugarColumnFlipP, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false);
 
   default:
     GALOIS_DIE("partition scheme specified is invalid: ", partitionScheme);
@@ -48,6 +48,12 @@ extern cll::opt<DataCommMode> commMetadata;
 //! Where to write output if output is set
 extern cll::opt<std::string> outputLocation;
 extern cll::opt<bool> output;
+//! Rounds between checkpoints; 0 disables checkpointing
+extern cll::opt<unsigned> checkpointInterval;
+//! Directory to write checkpoints to
+extern cll::opt<std::string> checkpointDir;
+//! If set, resume from the last consistent checkpoint
+extern cll::opt<bool> restartFromCheckpoint;
 
 #ifdef GALOIS_ENABLE_GPU
 enum Personality { CPU, GPU_CUDA };
@@ -75,6 +81,27 @@ extern cll::opt<std::string> personality_set;
 void DistBenchStart(int argc, char** argv, const char* app,
                     const char* desc = nullptr, const char* url = nullptr);
 
+/**
+ * Determines if a checkpoint should be taken at a round boundary.
+ *
+ * @param round Number of rounds completed so far
+ * @returns true if checkpointing is enabled and round is a multiple of the
+ * checkpoint interval
+ */
+inline bool checkpointDue(uint32_t round) {
+  return checkpointInterval && round && (round % checkpointInterval) == 0;
+}
+
+/**
+ * Get the path prefix of the checkpoint files of a field.
+ *
+ * @param field Name of the checkpointed field
+ * @returns Path prefix to pass to the checkpoint calls of the substrate
+ */
+inline std::string checkpointPath(const std::string& field) {
+  return checkpointDir + "/" + field;
+}
+
 template <typename NodeData, typename EdgeData>
 using DistGraphPtr =
     std::unique_ptr<galois::graphs::DistGraph<NodeData, EdgeData>>;
@@ -151,9 +178,12 @@ loadDistGraph(std::vector<unsigned>& scaleFactor) {
 
   dGraphTimer.stop();
 
+  reportReplicationFactor(*loadedGraph);
+
   // Save local graph structure
-  // if (saveLocalGraph)
-  //  (*loadedGraph).save_local_graph_to_file(localGraphFileName);
+  if (saveLocalGraph) {
+    loadedGraph->save_local_graph_to_file(localGraphFileName);
+  }
 
   return loadedGraph;
 }
@@ -193,9 +223,12 @@ loadSymmetricDistGraph(std::vector<unsigned>& scaleFactor) {
 
   dGraphTimer.stop();
 
+  reportReplicationFactor(*loadedGraph);
+
   // Save local graph structure
-  // if (saveLocalGraph)
-  //  (*loadedGraph).save_local_graph_to_file(localGraphFileName);
+  if (saveLocalGraph) {
+    loadedGraph->save_local_graph_to_file(localGraphFileName);
+  }
 
   return loadedGraph;
 }
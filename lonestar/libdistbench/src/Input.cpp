@@ -25,6 +25,12 @@
  */
 
 #include "DistBench/Input.h"
+#include "galois/graphs/BufferedGraph.h"
+#include "galois/graphs/OfflineGraph.h"
+#include "galois/runtime/Collectives.h"
+
+#include <atomic>
+#include <cmath>
 
 using namespace galois::graphs;
 
@@ -57,20 +63,23 @@ cll::opt<PARTITIONING_SCHEME> partitionScheme(
         clEnumValN(FENNEL_I, "fennel-i",
                    "fennel, incoming edge cut, using CuSP"),
         clEnumValN(SUGAR_O, "sugar-o",
-                   "fennel, incoming edge cut, using CuSP")),
+                   "fennel, incoming edge cut, using CuSP"),
+        clEnumValN(AUTO, "auto",
+                   "Pick the scheme predicted to communicate least from "
+                   "sampled graph statistics")),
     cll::init(OEC));
 
 cll::opt<bool> readFromFile("readFromFile",
                             cll::desc("Set this flag if graph is to be "
                                       "constructed from file (file must be "
-                                      "created by Abelian CSR)"),
+                                      "created by -saveLocalGraph)"),
                             cll::init(false), cll::Hidden);
 
 cll::opt<std::string>
     localGraphFileName("localGraphFileName",
                        cll::desc("Name of the local file to construct "
                                  "local graph (file must be created by "
-                                 "Abelian CSR)"),
+                                 "-saveLocalGraph)"),
                        cll::init("local_graph"), cll::Hidden);
 
 cll::opt<bool> saveLocalGraph("saveLocalGraph",
@@ -80,3 +89,302 @@ cll::opt<bool> saveLocalGraph("saveLocalGraph",
 cll::opt<std::string> mastersFile("mastersFile",
                                   cll::desc("File specifying masters blocking"),
                                   cll::init(""), cll::Hidden);
+
+cll::opt<uint64_t> partitionMemoryBudget(
+    "partitionMemoryBudget",
+    cll::desc("Per-host memory budget in MB for edges read from disk and "
+              "edges waiting to be sent during partitioning; if non-zero, "
+              "edges are streamed from disk in windows that fit the budget "
+              "(default 0: read all at once)"),
+    cll::init(0));
+
+double predictedReplicationFactor = 0;
+
+namespace {
+
+//! Number of nodes whose proxies are counted to predict replication factors
+constexpr uint64_t autoSampleNodes = 1 << 14;
+//! Out-degree above which GenericHVC assigns edges to the destination
+constexpr uint64_t hvcDegreeThreshold = 1000;
+
+//! Policies whose proxies are counted on each graph file read by CuSP; on
+//! the transpose they become the incoming variants
+enum SampledPolicy { edgeCut, hybridCut, cartesianCut, numSampledPolicies };
+
+//! Evenly spaced nodes of the input graph
+struct NodeSample {
+  uint64_t numSamples = 0;
+  uint64_t stride     = 1;
+
+  bool contains(uint64_t n) const {
+    return (n % stride == stride / 2) && (n / stride < numSamples);
+  }
+  uint64_t indexOf(uint64_t n) const { return n / stride; }
+  uint64_t node(uint64_t i) const { return i * stride + stride / 2; }
+};
+
+/**
+ * Gets the first node of the block of every host when nodes are blocked so
+ * that every host has about the same number of edges, as the master
+ * assignment of the generic policies does. The last entry is the number of
+ * nodes.
+ */
+std::vector<uint64_t> edgeBalancedBlocks(galois::graphs::OfflineGraph& g,
+                                         unsigned numHosts) {
+  std::vector<uint64_t> begins(numHosts + 1, g.size());
+  for (unsigned h = 0; h < numHosts; ++h) {
+    uint64_t target = g.sizeEdges() * h / numHosts;
+    uint64_t lo = 0, hi = g.size();
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (*g.edge_begin(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    begins[h] = lo;
+  }
+  return begins;
+}
+
+/**
+ * Marks, for every sampled node and every sampled policy, the hosts that
+ * would get a proxy of the node if a graph file were partitioned with that
+ * policy. Every host only reads the edges of its own block of masters, so
+ * the marks of all hosts together cover every edge exactly once.
+ *
+ * @param file Graph file as CuSP would read it
+ * @param sample Sampled nodes
+ * @param numColumns Number of columns of the Cartesian grid of hosts
+ * @param owners Bitmaps of hosts indexed by policy, sample and word
+ * @param maxDegree Updated with the largest out-degree in this block
+ * @returns master host of every sampled node
+ */
+std::vector<unsigned> markProxies(const std::string& file,
+                                  const NodeSample& sample,
+                                  unsigned numColumns,
+                                  std::vector<std::atomic<uint64_t>>& owners,
+                                  galois::GReduceMax<uint64_t>& maxDegree) {
+  auto& net = galois::runtime::getSystemNetworkInterface();
+  galois::graphs::OfflineGraph g(file);
+  std::vector<uint64_t> blocks = edgeBalancedBlocks(g, net.Num);
+  auto masterOf                = [&](uint64_t n) -> unsigned {
+    return std::upper_bound(blocks.begin(), blocks.end(), n) -
+           blocks.begin() - 1;
+  };
+
+  uint64_t words = (net.Num + 63) / 64;
+  auto mark      = [&](unsigned policy, uint64_t n, unsigned host) {
+    uint64_t word = (policy * sample.numSamples + sample.indexOf(n)) * words +
+                    host / 64;
+    owners[word].fetch_or(uint64_t{1} << (host % 64),
+                          std::memory_order_relaxed);
+  };
+
+  uint64_t nodeBegin = blocks[net.ID];
+  uint64_t nodeEnd   = blocks[net.ID + 1];
+  galois::graphs::BufferedGraph<void> block;
+  block.loadPartialGraph(file, nodeBegin, nodeEnd, *g.edge_begin(nodeBegin),
+                         *g.edge_begin(nodeEnd), g.size(), g.sizeEdges());
+
+  galois::do_all(
+      galois::iterate(nodeBegin, nodeEnd),
+      [&](uint64_t src) {
+        uint64_t degree = *block.edgeEnd(src) - *block.edgeBegin(src);
+        maxDegree.update(degree);
+        unsigned srcMaster = masterOf(src);
+        bool srcSampled    = sample.contains(src);
+        for (auto e = block.edgeBegin(src); e != block.edgeEnd(src); ++e) {
+          uint64_t dst    = block.edgeDestination(*e);
+          bool dstSampled = sample.contains(dst);
+          if (!srcSampled && !dstSampled) {
+            continue;
+          }
+          unsigned dstMaster = masterOf(dst);
+          // edge owners as in NoCommunication, GenericHVC and GenericCVC
+          unsigned edgeOwners[numSampledPolicies] = {
+              srcMaster,
+              (degree > hvcDegreeThreshold) ? dstMaster : srcMaster,
+              (srcMaster / numColumns) * numColumns + dstMaster % numColumns};
+          for (unsigned p = 0; p < numSampledPolicies; ++p) {
+            if (srcSampled) {
+              mark(p, src, edgeOwners[p]);
+            }
+            if (dstSampled) {
+              mark(p, dst, edgeOwners[p]);
+            }
+          }
+        }
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("AutoPartitionSample"));
+
+  std::vector<unsigned> masters(sample.numSamples);
+  for (uint64_t i = 0; i < sample.numSamples; ++i) {
+    masters[i] = masterOf(sample.node(i));
+  }
+  return masters;
+}
+
+//! Prediction for one partitioning scheme
+struct SchemePrediction {
+  PARTITIONING_SCHEME scheme;
+  double replicationFactor;
+  double syncVolume;
+};
+
+} // namespace
+
+void resolveAutoPartitionScheme(bool iterateOut, bool symmetricGraph) {
+  if (partitionScheme != AUTO) {
+    return;
+  }
+  auto& net = galois::runtime::getSystemNetworkInterface();
+  // a single host or a saved partition has nothing to pick
+  if (net.Num == 1 || readFromFile) {
+    partitionScheme = OEC;
+    return;
+  }
+#ifdef GALOIS_USE_LCI
+  if (net.ID == 0) {
+    galois::gWarn("-partition=auto needs MPI collectives; using oec");
+  }
+  partitionScheme = OEC;
+  (void)iterateOut;
+  (void)symmetricGraph;
+#else
+  galois::StatTimer autoTimer("AutoPartitionTime", "DistBench");
+  autoTimer.start();
+
+  // same grid as the Cartesian vertex cut
+  unsigned numColumns = std::sqrt(net.Num);
+  while (net.Num % numColumns) {
+    numColumns--;
+  }
+  unsigned numRows = net.Num / numColumns;
+  bool cvcIsCut    = (numRows > 1) && (numColumns > 1);
+
+  std::vector<std::string> files{inputFile};
+  if (!symmetricGraph && !inputFileTranspose.empty()) {
+    files.push_back(inputFileTranspose);
+  }
+
+  NodeSample sample;
+  uint64_t numNodes = 0, numEdges = 0;
+  try {
+    galois::graphs::OfflineGraph g(inputFile);
+    numNodes = g.size();
+    numEdges = g.sizeEdges();
+  } catch (const char* error) {
+    GALOIS_DIE("failed to read ", inputFile, " for -partition=auto: ", error);
+  }
+  sample.numSamples = std::min(numNodes, autoSampleNodes);
+  sample.stride     = sample.numSamples ? numNodes / sample.numSamples : 1;
+
+  uint64_t words       = (net.Num + 63) / 64;
+  uint64_t fileEntries = numSampledPolicies * sample.numSamples * words;
+  std::vector<std::atomic<uint64_t>> owners(files.size() * fileEntries);
+  std::vector<std::vector<unsigned>> masters;
+  galois::GReduceMax<uint64_t> maxDegree;
+  for (size_t f = 0; f < files.size(); ++f) {
+    std::vector<std::atomic<uint64_t>> fileOwners(fileEntries);
+    try {
+      masters.push_back(
+          markProxies(files[f], sample, numColumns, fileOwners, maxDegree));
+    } catch (const char* error) {
+      GALOIS_DIE("failed to read ", files[f], " for -partition=auto: ",
+                 error);
+    }
+    for (uint64_t w = 0; w < fileEntries; ++w) {
+      owners[f * fileEntries + w] = fileOwners[w].load();
+    }
+  }
+
+  // or the proxies marked by all hosts together; the max out-degree rides
+  // along in the same batch
+  std::vector<galois::runtime::BatchedValue> batch;
+  batch.reserve(owners.size() + 1);
+  for (auto& w : owners) {
+    batch.push_back(galois::runtime::BatchedValue::make<uint64_t>(
+        galois::runtime::BatchedOp::bitOr, w.load()));
+  }
+  batch.push_back(galois::runtime::BatchedValue::make<uint64_t>(
+      galois::runtime::BatchedOp::max, maxDegree.reduce()));
+  galois::runtime::HierarchicalAllreduce collective;
+  collective.start(batch);
+  collective.wait();
+
+  // mean number of mirrors of the sampled nodes for a policy on a file
+  auto meanMirrors = [&](size_t f, unsigned policy) {
+    uint64_t mirrors = 0;
+    for (uint64_t i = 0; i < sample.numSamples; ++i) {
+      uint64_t base = f * fileEntries + (policy * sample.numSamples + i) * words;
+      unsigned master = masters[f][i];
+      for (uint64_t w = 0; w < words; ++w) {
+        uint64_t bits = batch[base + w].get<uint64_t>();
+        if (w == master / 64) {
+          bits &= ~(uint64_t{1} << (master % 64));
+        }
+        mirrors += __builtin_popcountll(bits);
+      }
+    }
+    return static_cast<double>(mirrors) /
+           std::max<uint64_t>(sample.numSamples, 1);
+  };
+
+  std::vector<SchemePrediction> predictions;
+  auto predict = [&](PARTITIONING_SCHEME scheme, size_t f, unsigned policy,
+                     unsigned phases) {
+    double mirrors = meanMirrors(f, policy);
+    predictions.push_back({scheme, 1 + mirrors, mirrors * phases});
+  };
+  predict(OEC, 0, edgeCut, 1);
+  predict(HOVC, 0, hybridCut, 2);
+  predict(CART_VCUT, 0, cartesianCut, cvcIsCut ? 2 : 1);
+  if (files.size() > 1) {
+    predict(IEC, 1, edgeCut, 1);
+    predict(HIVC, 1, hybridCut, 2);
+    predict(CART_VCUT_IEC, 1, cartesianCut, cvcIsCut ? 2 : 1);
+  }
+
+  // the edge cut that balances the edges the application iterates over
+  PARTITIONING_SCHEME preferred = iterateOut ? OEC : IEC;
+  auto cost                     = [&](const SchemePrediction& p) {
+    // a small margin so that near ties go to the preferred edge cut
+    return p.syncVolume * ((p.scheme == preferred) ? 0.95 : 1.0);
+  };
+  const SchemePrediction* best = &predictions.front();
+  for (auto& p : predictions) {
+    if (cost(p) < cost(*best)) {
+      best = &p;
+    }
+  }
+
+  autoTimer.stop();
+
+  if (net.ID == 0) {
+    uint64_t maxOutDegree = batch.back().get<uint64_t>();
+    double avgDegree =
+        numNodes ? static_cast<double>(numEdges) / numNodes : 0.0;
+
+    galois::gPrint("-partition=auto: counted proxies of ", sample.numSamples,
+                   " sampled nodes; average degree ", avgDegree,
+                   ", max degree ", maxOutDegree, "\n");
+    for (auto& p : predictions) {
+      galois::gPrint("  ", EnumToString(p.scheme),
+                     ": predicted replication factor ", p.replicationFactor,
+                     ", sync volume per node ", p.syncVolume, "\n");
+    }
+    galois::gPrint("-partition=auto picked ", EnumToString(best->scheme),
+                   "\n");
+    galois::runtime::reportParam("DistBench", "AutoPartitionScheme",
+                                 EnumToString(best->scheme));
+    galois::runtime::reportStat_Single(
+        "DistBench", "DegreeSkew", avgDegree ? maxOutDegree / avgDegree : 0.0);
+  }
+
+  partitionScheme            = best->scheme;
+  predictedReplicationFactor = best->replicationFactor;
+#endif
+}
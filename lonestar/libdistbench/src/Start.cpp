@@ -61,6 +61,23 @@ cll::opt<std::string> outputLocation(
 cll::opt<bool> output("output", cll::desc("Write result (default false)"),
                       cll::init(false));
 
+cll::opt<unsigned> checkpointInterval(
+    "checkpointInterval",
+    cll::desc("Checkpoint node data every this many rounds in apps that "
+              "support it (default 0, never)"),
+    cll::init(0));
+cll::opt<std::string>
+    checkpointDir("checkpointDir",
+                  cll::desc("Directory to write checkpoints and the cached "
+                            "partition to (default .)"),
+                  cll::init("."));
+cll::opt<bool> restartFromCheckpoint(
+    "restart",
+    cll::desc("Resume the first run from the last checkpoint completed by "
+              "every host in the first run of the checkpointed process, "
+              "using the partition it cached"),
+    cll::init(false));
+
 #ifdef GALOIS_ENABLE_GPU
 std::string personality_str(Personality p) {
   switch (p) {
@@ -116,6 +133,19 @@ void DistBenchStart(int argc, char** argv, const char* app, const char* desc,
   numThreads = galois::setActiveThreads(numThreads);
   galois::runtime::setStatFile(statFile);
 
+  // checkpointed runs cache their partition so that a restart does not have
+  // to partition again
+  if (checkpointInterval || restartFromCheckpoint) {
+    if (!localGraphFileName.getNumOccurrences()) {
+      localGraphFileName = checkpointDir + "/local_graph";
+    }
+    if (restartFromCheckpoint) {
+      readFromFile = true;
+    } else {
+      saveLocalGraph = true;
+    }
+  }
+
   auto& net = galois::runtime::getSystemNetworkInterface();
 
   if (net.ID == 0) {